@@ -0,0 +1,207 @@
+//  file: bench_timer.cpp
+//
+//  Member functions for the Benchmark timing harness.
+//
+//  Revision history:
+//   14/05/21  original version
+//
+//  Notes:
+//   * wall time comes from std::chrono::steady_clock, which is monotonic
+//      and has sub-microsecond resolution on Linux, macOS and Windows
+//      (clock() ticks hid anything under about a millisecond).
+//   * cycles come from the x86 time-stamp counter when the compiler
+//      offers __rdtsc.  The TSC runs at the nominal clock, so with turbo
+//      boost the core does somewhat more cycles than reported.
+//   * the median is used for the per-sample figures; the p95 shows how
+//      noisy the machine was.
+//
+//******************************************************************
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <chrono>
+using namespace std;
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BENCH_HAVE_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+#include "bench_timer.hpp"
+
+//********************************************************************
+static inline unsigned long long
+cycle_count ()
+{
+#ifdef BENCH_HAVE_TSC
+  return (__rdtsc ());
+#else
+  return (0);
+#endif
+}
+
+// value at fraction q of the sorted data (nearest rank), q in (0,1]
+static double
+percentile (const vector<double> &sorted, double q)
+{
+  size_t n = sorted.size ();
+  size_t rank = size_t (ceil (q * double (n)));
+  if (rank < 1)
+  {
+    rank = 1;
+  }
+  return (sorted[rank - 1]);
+}
+
+static double
+median (const vector<double> &sorted)
+{
+  size_t n = sorted.size ();
+  if (n % 2 == 1)
+  {
+    return (sorted[n / 2]);
+  }
+  return (0.5 * (sorted[n / 2 - 1] + sorted[n / 2]));
+}
+
+//********************************************************************
+bool
+Benchmark::has_cycle_counter ()
+{
+#ifdef BENCH_HAVE_TSC
+  return (true);
+#else
+  return (false);
+#endif
+}
+
+Benchmark::Benchmark (int warmup_runs, int trial_runs)
+{
+  warmup = (warmup_runs < 0 ? 0 : warmup_runs);
+  trials = (trial_runs < 1 ? 1 : trial_runs);
+}
+
+//********************************************************************
+const BenchResult &
+Benchmark::run (const string &name, long long samples, function<double ()> f)
+{
+  vector<double> seconds (trials);
+  vector<double> cycles (trials);
+  double value = 0.;
+
+  for (int i = 0; i < warmup; i++)
+  {
+    value = f ();
+  }
+
+  for (int i = 0; i < trials; i++)
+  {
+    chrono::steady_clock::time_point tb = chrono::steady_clock::now ();
+    unsigned long long cb = cycle_count ();
+    value = f ();
+    unsigned long long ce = cycle_count ();
+    chrono::steady_clock::time_point te = chrono::steady_clock::now ();
+
+    seconds[i] = chrono::duration<double> (te - tb).count ();
+    cycles[i] = double (ce - cb);
+  }
+
+  double sum = 0.;
+  for (int i = 0; i < trials; i++)
+  {
+    sum += seconds[i];
+  }
+  sort (seconds.begin (), seconds.end ());
+  sort (cycles.begin (), cycles.end ());
+
+  BenchResult r;
+  r.name = name;
+  r.samples = samples;
+  r.trials = trials;
+  r.min_s = seconds[0];
+  r.median_s = median (seconds);
+  r.p95_s = percentile (seconds, 0.95);
+  r.mean_s = sum / double (trials);
+  r.ns_per_sample = (samples > 0 ? 1.e9 * r.median_s / double (samples) : 0.);
+  r.cycles_per_sample = (samples > 0 && has_cycle_counter ()
+                         ? median (cycles) / double (samples) : 0.);
+  r.value = value;
+
+  results.push_back (r);
+  return (results.back ());
+}
+
+//********************************************************************
+void
+Benchmark::print (ostream &out) const
+{
+  ios::fmtflags old_flags = out.flags ();
+  streamsize old_precision = out.precision ();
+
+  out << left << setw (16) << "# name" << right << setw (13) << "samples"
+      << setw (12) << "median(s)" << setw (12) << "p95(s)"
+      << setw (11) << "ns/sample" << setw (14) << "cycles/sample"
+      << setw (16) << "value" << endl;
+  for (size_t i = 0; i < results.size (); i++)
+  {
+    const BenchResult &r = results[i];
+    out << left << setw (16) << r.name << right << setw (13) << r.samples
+        << scientific << setprecision (3)
+        << setw (12) << r.median_s << setw (12) << r.p95_s
+        << fixed << setprecision (3)
+        << setw (11) << r.ns_per_sample << setw (14) << r.cycles_per_sample;
+    out.unsetf (ios::floatfield);
+    out << setprecision (10) << setw (16) << r.value << endl;
+  }
+
+  out.flags (old_flags);
+  out.precision (old_precision);
+}
+
+void
+Benchmark::write_csv (ostream &out) const
+{
+  out << "name,samples,trials,min_s,median_s,p95_s,mean_s,"
+      << "ns_per_sample,cycles_per_sample,value" << endl;
+  out << setprecision (10);
+  for (size_t i = 0; i < results.size (); i++)
+  {
+    const BenchResult &r = results[i];
+    out << "\"" << r.name << "\"," << r.samples << "," << r.trials << ","
+        << r.min_s << "," << r.median_s << "," << r.p95_s << ","
+        << r.mean_s << "," << r.ns_per_sample << ","
+        << r.cycles_per_sample << "," << r.value << endl;
+  }
+}
+
+void
+Benchmark::write_json (ostream &out) const
+{
+  out << "[" << endl << setprecision (10);
+  for (size_t i = 0; i < results.size (); i++)
+  {
+    const BenchResult &r = results[i];
+    string name;
+    for (size_t c = 0; c < r.name.size (); c++)
+    {
+      if (r.name[c] == '"' || r.name[c] == '\\')
+      {
+        name += '\\';
+      }
+      name += r.name[c];
+    }
+    out << "  {\"name\": \"" << name << "\", \"samples\": " << r.samples
+        << ", \"trials\": " << r.trials
+        << ", \"min_s\": " << r.min_s << ", \"median_s\": " << r.median_s
+        << ", \"p95_s\": " << r.p95_s << ", \"mean_s\": " << r.mean_s
+        << ", \"ns_per_sample\": " << r.ns_per_sample
+        << ", \"cycles_per_sample\": " << r.cycles_per_sample
+        << ", \"value\": " << r.value << "}"
+        << (i + 1 < results.size () ? "," : "") << endl;
+  }
+  out << "]" << endl;
+}
@@ -0,0 +1,57 @@
+//  file: bench_timer.hpp
+//
+//  Header file for the Benchmark class, a small portable timing harness:
+//   warm-up runs, repeated timed trials with std::chrono::steady_clock,
+//   median/p95 statistics, cycles per sample, and CSV/JSON output.
+//
+//  Revision history:
+//   14/05/21  original version, replaces clock() ticks and SYSTEMTIME
+//
+#ifndef BENCH_TIMER_HPP
+#define BENCH_TIMER_HPP
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// summary of the trials of one benchmark
+struct BenchResult
+{
+  std::string name;		// label, e.g. "Halton MC"
+  long long samples;		// work items (points, steps, ...) per trial
+  int trials;			// number of timed trials
+  double min_s;			// fastest trial (seconds)
+  double median_s;		// median trial
+  double p95_s;			// 95th percentile trial
+  double mean_s;		// mean trial
+  double ns_per_sample;		// 1e9 * median_s / samples
+  double cycles_per_sample;	// TSC cycles per sample, median trial (0 if unknown)
+  double value;			// what the last trial returned (e.g. pi)
+};
+
+class Benchmark
+{
+public:
+  Benchmark (int warmup_runs = 2, int trial_runs = 10);
+
+  // Time f(), which processes `samples` items and returns a result worth
+  //  keeping (this also stops the compiler discarding the work).
+  const BenchResult &run (const std::string &name, long long samples,
+                          std::function<double ()> f);
+
+  const std::vector<BenchResult> &get_results () const { return results; };
+
+  void print (std::ostream &out) const;		// aligned table
+  void write_csv (std::ostream &out) const;	// one row per benchmark
+  void write_json (std::ostream &out) const;	// array of objects
+
+  static bool has_cycle_counter ();	// true if cycles_per_sample is measured
+
+private:
+  int warmup;			// untimed runs before the trials
+  int trials;			// timed runs
+  std::vector<BenchResult> results;
+};
+
+#endif
@@ -1,6 +1,7 @@
 double *halton ( int i, int m );
 double *halton_base ( int i, int m, int b[] );
 double *halton_sequence ( int i1, int i2, int m );
+void halton_sequence_fill ( int i1, int i2, int m, double r[] );
 int i4vec_sum ( int n, int a[] );
 int prime ( int n );
 
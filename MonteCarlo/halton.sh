@@ -1,13 +1,21 @@
 #! /bin/bash
 #
 cp halton.hpp /$HOME/include
+cp halton_stream.hpp /$HOME/include
+cp prime_table.hpp /$HOME/include
 #
 g++ -c -Wall -I/$HOME/include halton.cpp
 if [ $? -ne 0 ]; then
   echo "Compile error."
   exit
 fi
+g++ -c -Wall -I/$HOME/include halton_stream.cpp
+if [ $? -ne 0 ]; then
+  echo "Compile error."
+  exit
+fi
 #
 mv halton.o ~/libcpp/halton.o
+mv halton_stream.o ~/libcpp/halton_stream.o
 #
 echo "Normal end of execution."
@@ -0,0 +1,147 @@
+//  file: halton_bench.cpp
+//
+//  Benchmark of halton_sequence() for m = 10 dimensions: the original
+//   point-by-point loop (three prime() calls per digit, each copying the
+//   1600-entry list onto the stack) against the batched, table-driven
+//   halton_sequence_fill() and against HaltonStream::fill().
+//
+//  Revision history:
+//   18/05/21  original version
+//
+//  Notes:
+//   * the original loop takes tens of microseconds per point, so it is
+//      timed on n_legacy points only; ns/point does not depend on n much
+//      (the digit count grows like log n), so the ratio of the ns/point
+//      columns is the speedup at n = 1e7.
+//   * compile with make -f make_halton_bench; results also go to
+//      halton_bench.csv
+//
+//*********************************************************************//
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+using namespace std;
+
+#include "halton.hpp"
+#include "halton_stream.hpp"
+#include "prime_table.hpp"
+#include "bench_timer.hpp"
+
+void halton_sequence_legacy (int i1, int i2, int m, double r[]);
+
+//*********************************************************************//
+int
+main (void)
+{
+  const int m = 10;
+  const int n = 10000000;
+  const int n_legacy = 20000;
+
+  double *r = new double[(long long) m * n];
+  double *r_legacy = new double[m * n_legacy];
+  double **soa = new double *[m];
+  for (int j = 0; j < m; j++)
+  {
+    soa[j] = new double[n];
+  }
+
+  // same bits as the original code?
+  halton_sequence_legacy (0, n_legacy - 1, m, r_legacy);
+  halton_sequence_fill (0, n_legacy - 1, m, r);
+  bool same = (memcmp (r, r_legacy, sizeof (double) * m * n_legacy) == 0);
+  cout << "halton_sequence_fill() matches the original loop bit for bit: "
+       << (same ? "yes" : "NO") << endl << endl;
+
+  Benchmark bench (1, 5);
+  double legacy_ns = bench.run ("original", n_legacy, [&] () {
+    halton_sequence_legacy (0, n_legacy - 1, m, r_legacy);
+    return (r_legacy[m * n_legacy - 1]);
+  }).ns_per_sample;
+  bench.run ("fill (small)", n_legacy, [&] () {
+    halton_sequence_fill (0, n_legacy - 1, m, r);
+    return (r[m * n_legacy - 1]);
+  });
+  double batched_ns = bench.run ("fill", n, [&] () {
+    halton_sequence_fill (0, n - 1, m, r);
+    return (r[(long long) m * n - 1]);
+  }).ns_per_sample;
+  bench.run ("HaltonStream", n, [&] () {
+    HaltonStream hs (m);
+    hs.fill (n, soa);
+    return (soa[m - 1][n - 1]);
+  });
+  bench.print (cout);
+
+  cout << endl << "speedup of halton_sequence_fill over the original, m = "
+       << m << ", n = " << n << ": " << legacy_ns / batched_ns << endl;
+
+  ofstream csv ("halton_bench.csv");
+  bench.write_csv (csv);
+
+  for (int j = 0; j < m; j++)
+  {
+    delete[] soa[j];
+  }
+  delete[] soa;
+  delete[] r_legacy;
+  delete[] r;
+  return (same ? 0 : 1);
+}
+
+//*********************************************************************//
+// prime() as it was: the list is a local array, copied on every call.
+//  The copy goes through a volatile function pointer so the compiler
+//  cannot see through it and read the table directly.
+static int
+prime_legacy (int n)
+{
+  static void *(*volatile copy) (void *, const void *, size_t) = memcpy;
+  int npvec[PRIME_TABLE_MAX];
+
+  copy (npvec, prime_table.p, sizeof (npvec));
+  return (npvec[n - 1]);
+}
+
+// copy of the original halton_sequence() loop, writing into r
+void
+halton_sequence_legacy (int i1, int i2, int m, double r[])
+{
+  int i3 = (i1 <= i2 ? +1 : -1);
+  int n = abs (i2 - i1) + 1;
+  double *prime_inv = new double[m];
+  int *t = new int[m];
+
+  for (int k = 0; k < n * m; k++)
+  {
+    r[k] = 0.0;
+  }
+
+  int i = i1;
+  for (int k = 0; k < n; k++)
+  {
+    for (int j = 0; j < m; j++)
+    {
+      t[j] = i;
+    }
+    for (int j = 0; j < m; j++)
+    {
+      prime_inv[j] = 1.0 / (double) (prime_legacy (j + 1));
+    }
+    while (0 < i4vec_sum (m, t))
+    {
+      for (int j = 0; j < m; j++)
+      {
+        int d = (t[j] % prime_legacy (j + 1));
+        r[j + k * m] = r[j + k * m] + (double) (d) * prime_inv[j];
+        prime_inv[j] = prime_inv[j] / (double) (prime_legacy (j + 1));
+        t[j] = (t[j] / prime_legacy (j + 1));
+      }
+    }
+    i = i + i3;
+  }
+
+  delete[] prime_inv;
+  delete[] t;
+}
@@ -0,0 +1,374 @@
+//  file: halton_stream.cpp
+//
+//  Member functions for the HaltonStream class, which generates
+//   consecutive elements of a Halton sequence incrementally.
+//
+//  Revision history:
+//   06/05/21  original version
+//   16/05/21  added scramble()/unscramble()
+//
+//  Notes:
+//   * the index i is held as its base-b digits for each dimension.
+//      Stepping to i+1 adds one to the lowest digit and carries; on
+//      average a carry reaches only 1/(b-1) digits further, so this is
+//      amortized O(1) per dimension.
+//   * the coordinate is summed from the least significant digit up with
+//      weights 1/b, 1/b/b, ... exactly as halton_base() does.  Updating the
+//      coordinate by adding and subtracting weights would be cheaper still,
+//      but the rounding would drift away from halton_base() for any base
+//      that is not a power of two.
+//
+//****************************************************************************80
+
+# include <cstdlib>
+# include <iostream>
+
+using namespace std;
+
+# include "halton.hpp"
+# include "halton_stream.hpp"
+
+//****************************************************************************80
+
+HaltonStream::HaltonStream ( int m )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    HALTONSTREAM sets up a stream using the first M primes as bases,
+//    matching HALTON and HALTON_SEQUENCE.
+//
+//  Parameters:
+//
+//    Input, int M, the spatial dimension.
+//
+{
+  int j;
+  vector<int> b ( m > 0 ? m : 1 );
+
+  for ( j = 0; j < m; j++ )
+  {
+    b[j] = prime ( j + 1 );
+  }
+  init ( m, &b[0] );
+}
+//****************************************************************************80
+
+HaltonStream::HaltonStream ( int m, const int b[] )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    HALTONSTREAM sets up a stream with user bases, matching HALTON_BASE.
+//
+//  Parameters:
+//
+//    Input, int M, the spatial dimension.
+//
+//    Input, int B[M], the bases to use for each dimension.
+//
+{
+  init ( m, b );
+}
+//****************************************************************************80
+
+void HaltonStream::init ( int m, const int b[] )
+
+//****************************************************************************80
+{
+  int j;
+  int k;
+
+  if ( m < 1 )
+  {
+    cerr << "\n";
+    cerr << "HALTONSTREAM - Fatal error!\n";
+    cerr << "  Spatial dimension M = " << m << " must be at least 1.\n";
+    exit ( 1 );
+  }
+
+  dim = m;
+  base.assign ( b, b + m );
+  num_digits.assign ( m, 0 );
+  digit.assign ( m * max_digits, 0 );
+  weight.assign ( m * max_digits, 0.0 );
+
+  for ( j = 0; j < m; j++ )
+  {
+    if ( base[j] < 2 )
+    {
+      cerr << "\n";
+      cerr << "HALTONSTREAM - Fatal error!\n";
+      cerr << "  Base B[" << j << "] = " << base[j] << " must be at least 2.\n";
+      exit ( 1 );
+    }
+//
+//  Same recurrence as B_INV in HALTON_BASE, so the weights round identically.
+//
+    weight[j*max_digits] = 1.0 / ( double ) ( base[j] );
+    for ( k = 1; k < max_digits; k++ )
+    {
+      weight[j*max_digits+k] = weight[j*max_digits+k-1] / ( double ) ( base[j] );
+    }
+  }
+
+  index = 0;
+  scrambled = false;
+  perm.clear ();
+  perm_start.assign ( m, 0 );
+}
+//****************************************************************************80
+
+void HaltonStream::seek ( unsigned long long i )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    SEEK expands I into digits so that the next point returned has index I.
+//
+{
+  int j;
+  int k;
+  unsigned long long t;
+
+  for ( j = 0; j < dim; j++ )
+  {
+    int *d = &digit[j*max_digits];
+    unsigned long long b = ( unsigned long long ) base[j];
+
+    t = i;
+    k = 0;
+    while ( 0 < t )
+    {
+      d[k] = ( int ) ( t % b );
+      t = t / b;
+      k++;
+    }
+    num_digits[j] = k;
+    for ( ; k < max_digits; k++ )
+    {
+      d[k] = 0;
+    }
+  }
+  index = i;
+}
+//****************************************************************************80
+
+void HaltonStream::increment ()
+
+//****************************************************************************80
+{
+  int j;
+  int k;
+
+  for ( j = 0; j < dim; j++ )
+  {
+    int *d = &digit[j*max_digits];
+    int b = base[j];
+
+    k = 0;
+    while ( ++d[k] == b )
+    {
+      d[k] = 0;
+      k++;
+    }
+    if ( num_digits[j] <= k )
+    {
+      num_digits[j] = k + 1;
+    }
+  }
+  index++;
+}
+//****************************************************************************80
+
+void HaltonStream::scramble ( unsigned long long seed )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    SCRAMBLE draws a random digit permutation for every dimension.
+//
+//  Discussion:
+//
+//    The permutations come from a Fisher-Yates shuffle of 1..B-1 driven
+//    by a SplitMix64 counter, so the same seed always gives the same
+//    scrambled sequence.
+//
+{
+  int j;
+  int k;
+  int total = 0;
+  unsigned long long state = seed;
+
+  for ( j = 0; j < dim; j++ )
+  {
+    perm_start[j] = total;
+    total = total + base[j];
+  }
+  perm.resize ( total );
+
+  for ( j = 0; j < dim; j++ )
+  {
+    int *p = &perm[perm_start[j]];
+    for ( k = 0; k < base[j]; k++ )
+    {
+      p[k] = k;
+    }
+    for ( k = base[j] - 1; 1 < k; k-- )
+    {
+      state = state + 0x9e3779b97f4a7c15ULL;
+      unsigned long long z = state;
+      z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+      z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+      z = z ^ ( z >> 31 );
+      int l = 1 + ( int ) ( z % ( unsigned long long ) k );	// 1 <= l <= k
+      int t = p[k];
+      p[k] = p[l];
+      p[l] = t;
+    }
+  }
+  scrambled = true;
+}
+//****************************************************************************80
+
+void HaltonStream::unscramble ()
+
+//****************************************************************************80
+{
+  scrambled = false;
+  perm.clear ();
+}
+//****************************************************************************80
+
+double HaltonStream::value ( int j ) const
+
+//****************************************************************************80
+{
+  const int *d = &digit[j*max_digits];
+  const double *w = &weight[j*max_digits];
+  int k;
+  int n = num_digits[j];
+  double r = 0.0;
+
+  if ( scrambled )
+  {
+    const int *p = &perm[perm_start[j]];
+    for ( k = 0; k < n; k++ )
+    {
+      r = r + ( double ) ( p[d[k]] ) * w[k];
+    }
+  }
+  else
+  {
+    for ( k = 0; k < n; k++ )
+    {
+      r = r + ( double ) ( d[k] ) * w[k];
+    }
+  }
+  return r;
+}
+//****************************************************************************80
+
+void HaltonStream::next ( double r[] )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    NEXT returns the point with the current index and advances the stream.
+//
+//  Parameters:
+//
+//    Output, double R[M], the element of the sequence, equal to
+//    HALTON_BASE ( I, M, B ) for the current index I.
+//
+{
+  int j;
+
+  for ( j = 0; j < dim; j++ )
+  {
+    r[j] = value ( j );
+  }
+  increment ();
+}
+//****************************************************************************80
+
+void HaltonStream::fill ( long long n, double *r[] )
+
+//****************************************************************************80
+//
+//  Purpose:
+//
+//    FILL writes the next N points into a caller-provided SoA buffer.
+//
+//  Discussion:
+//
+//    Each dimension is run on its own over all N points, so the digit
+//    counter for that dimension stays in registers/L1 and the writes to
+//    R[J] are sequential.  Every dimension ends up N indices further on,
+//    which is the same state N calls to NEXT would leave.
+//
+//  Parameters:
+//
+//    Input, long long N, the number of points to generate.
+//
+//    Output, double *R[M], R[J][K] is coordinate J of point K, 0 <= K < N.
+//
+{
+  int j;
+  int k;
+  long long p;
+
+  if ( n <= 0 )
+  {
+    return;
+  }
+
+  for ( j = 0; j < dim; j++ )
+  {
+    int *d = &digit[j*max_digits];
+    const double *w = &weight[j*max_digits];
+    int b = base[j];
+    int nd = num_digits[j];
+    double *rj = r[j];
+    const int *pj = ( scrambled ? &perm[perm_start[j]] : 0 );
+
+    for ( p = 0; p < n; p++ )
+    {
+      double s = 0.0;
+      if ( pj )
+      {
+        for ( k = 0; k < nd; k++ )
+        {
+          s = s + ( double ) ( pj[d[k]] ) * w[k];
+        }
+      }
+      else
+      {
+        for ( k = 0; k < nd; k++ )
+        {
+          s = s + ( double ) ( d[k] ) * w[k];
+        }
+      }
+      rj[p] = s;
+
+      k = 0;
+      while ( ++d[k] == b )
+      {
+        d[k] = 0;
+        k++;
+      }
+      if ( nd <= k )
+      {
+        nd = k + 1;
+      }
+    }
+    num_digits[j] = nd;
+  }
+  index = index + ( unsigned long long ) n;
+}
+//****************************************************************************80
@@ -0,0 +1,66 @@
+//  file: halton_stream.hpp
+//
+//  Header file for the HaltonStream class, a stateful generator of
+//   consecutive Halton points.
+//
+//  halton_base() rebuilds every point from scratch (three heap arrays and
+//   a divide/modulo per digit).  HaltonStream keeps the base-b digits of
+//   the current index for each dimension and advances them with a carry,
+//   so stepping to the next point costs amortized O(1) digit updates per
+//   dimension and never allocates.  The coordinate is accumulated from the
+//   cached digits with the same weights and in the same order as
+//   halton_base(), so the two agree bit for bit.
+//
+//  Revision history:
+//   06/05/21  original version
+//   16/05/21  added digit-permutation scrambling
+//
+#ifndef HALTON_STREAM_HPP
+#define HALTON_STREAM_HPP
+
+#include <vector>
+
+class HaltonStream
+{
+public:
+  HaltonStream ( int m );		// bases are the first m primes, as in halton()
+  HaltonStream ( int m, const int b[] );	// user bases, as in halton_base()
+
+  // use the automatically generated copy constructor
+
+  void next ( double r[] );		// r[0..m-1] = current point, then advance
+  void fill ( long long n, double *r[] );	// r[j][k] = coordinate j of point k (SoA)
+  void seek ( unsigned long long i );	// jump so the next point has index i
+
+  // Replace each digit d of dimension j by perm_j[d], where perm_j is a
+  //  random permutation of 0..b_j-1 with perm_j[0] = 0 (so the infinite
+  //  tail of zero digits stays zero).  Different seeds give independent
+  //  scramblings; unscramble() goes back to plain Halton.
+  void scramble ( unsigned long long seed );
+  void unscramble ();
+  bool is_scrambled () { return scrambled; };
+
+  unsigned long long get_index () { return index; };	// index of the next point
+  int get_dim () { return dim; };	// spatial dimension
+
+  static const int max_digits = 64;	// enough digits for any 64-bit index
+
+private:
+  void init ( int m, const int b[] );
+  void increment ();			// add one to the index, carrying digits
+  double value ( int j ) const;		// radical inverse of dimension j
+
+  int dim;				// spatial dimension m
+  unsigned long long index;		// index of the next point
+
+  std::vector<int> base;		// base for each dimension
+  std::vector<int> num_digits;		// digits in use for each dimension
+  std::vector<int> digit;		// digit[j*max_digits+k], least significant first
+  std::vector<double> weight;		// weight[j*max_digits+k] = b^-(k+1), as in halton_base()
+
+  bool scrambled;			// true if perm is in use
+  std::vector<int> perm;		// digit permutations, dimension j at perm_start[j]
+  std::vector<int> perm_start;
+};
+
+#endif
@@ -0,0 +1,157 @@
+//  file: halton_stream_test.cpp
+//
+//  Test program for the HaltonStream class.  Every point is compared bit for
+//   bit against halton_base() and halton_sequence(), then the two ways of
+//   producing N two-dimensional points are timed.
+//
+//  Revision history:
+//   06/05/21  original version
+//
+//******************************************************************
+
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <ctime>
+using namespace std;
+
+#include "halton.hpp"
+#include "halton_stream.hpp"
+
+int check_base (int m, int b[], int n);	// next() against halton_base()
+int check_sequence (int m, int i1, int n);	// fill() against halton_sequence()
+
+//********************************************************************
+int
+main (void)
+{
+  int failures = 0;
+
+  int b1[1] = { 2 };
+  int b2[2] = { 2, 3 };
+  int b5[5] = { 3, 5, 7, 11, 13499 };
+
+  failures += check_base (1, b1, 100000);
+  failures += check_base (2, b2, 100000);
+  failures += check_base (5, b5, 100000);
+
+  failures += check_sequence (1, 0, 100000);
+  failures += check_sequence (10, 0, 20000);
+  failures += check_sequence (10, 123456, 20000);
+
+  // time N points in bases 2 and 3 both ways
+  const int N = 2000000;
+  double *x = new double[N];
+  double *y = new double[N];
+  double *xy[2] = { x, y };
+
+  clock_t tb = clock ();
+  for (int i = 0; i < N; i++)
+  {
+    double *r = halton_base (i, 2, b2);
+    x[i] = r[0];
+    y[i] = r[1];
+    delete[] r;
+  }
+  clock_t te = clock ();
+  double t_base = double (te - tb) / CLOCKS_PER_SEC;
+
+  HaltonStream hs (2, b2);
+  tb = clock ();
+  hs.fill (N, xy);
+  te = clock ();
+  double t_stream = double (te - tb) / CLOCKS_PER_SEC;
+
+  cout << N << " points: halton_base " << t_base << " s, HaltonStream::fill "
+       << t_stream << " s" << endl;
+
+  delete[] x;
+  delete[] y;
+
+  if (failures == 0)
+  {
+    cout << "All HaltonStream checks passed." << endl;
+  }
+  else
+  {
+    cout << failures << " HaltonStream checks FAILED." << endl;
+  }
+  return (failures == 0 ? 0 : 1);
+}
+
+//********************************************************************
+int
+check_base (int m, int b[], int n)
+{
+  HaltonStream hs (m, b);
+  double *r = new double[m];
+  int bad = 0;
+
+  for (int i = 0; i < n; i++)
+  {
+    double *h = halton_base (i, m, b);
+    hs.next (r);
+    if (memcmp (r, h, m * sizeof (double)) != 0)
+    {
+      bad++;
+    }
+    delete[] h;
+  }
+
+  // jump into the middle and check again
+  hs.seek (987654);
+  for (int i = 987654; i < 987654 + 1000; i++)
+  {
+    double *h = halton_base (i, m, b);
+    hs.next (r);
+    if (memcmp (r, h, m * sizeof (double)) != 0)
+    {
+      bad++;
+    }
+    delete[] h;
+  }
+  delete[] r;
+
+  cout << "next() vs halton_base, m = " << m << ": "
+       << (bad == 0 ? "ok" : "MISMATCH") << endl;
+  return (bad == 0 ? 0 : 1);
+}
+
+//********************************************************************
+int
+check_sequence (int m, int i1, int n)
+{
+  double *h = halton_sequence (i1, i1 + n - 1, m);
+  double **r = new double *[m];
+  for (int j = 0; j < m; j++)
+  {
+    r[j] = new double[n];
+  }
+
+  HaltonStream hs (m);
+  hs.seek (i1);
+  hs.fill (n, r);
+
+  int bad = 0;
+  for (int k = 0; k < n; k++)
+  {
+    for (int j = 0; j < m; j++)
+    {
+      if (memcmp (&r[j][k], &h[j + k * m], sizeof (double)) != 0)
+      {
+        bad++;
+      }
+    }
+  }
+
+  for (int j = 0; j < m; j++)
+  {
+    delete[] r[j];
+  }
+  delete[] r;
+  delete[] h;
+
+  cout << "fill() vs halton_sequence, m = " << m << ", i1 = " << i1 << ": "
+       << (bad == 0 ? "ok" : "MISMATCH") << endl;
+  return (bad == 0 ? 0 : 1);
+}
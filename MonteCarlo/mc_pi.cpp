@@ -0,0 +1,229 @@
+//  file: mc_pi.cpp
+//
+//  Streaming Monte Carlo estimate of pi from points in the unit square.
+//
+//  Revision history:
+//   08/05/21  original version, replaces randseq() and omc()
+//   10/05/21  added CounterSource and the OpenMP engine mc_pi_parallel()
+//   12/05/21  count_in_circle() dispatches to the SIMD kernels
+//
+//  Notes:
+//   * points are generated mc_pi_block at a time into two small buffers
+//      that stay in cache, counted and thrown away, so memory use does not
+//      depend on N.  Counts are long long, so N can go to ~1e18 in
+//      principle; 1e11 takes minutes rather than running out of memory.
+//   * the standard error printed is the binomial one, 4 sqrt(p(1-p)/n)
+//      with p = inside/n.  For the Halton points this is only the error a
+//      pseudo-random run of the same length would have; the actual error
+//      of a quasi-random run is usually much smaller.
+//   * CounterSource hashes (seed, index) with the SplitMix64 finalizer
+//      instead of stepping a generator, so every thread can start at its
+//      own index with no jump-ahead and no shared state.
+//   * mc_pi_parallel() splits [i0, i0+N) into one contiguous index range
+//      per thread.  The in-circle counts are integers, so their sum does
+//      not depend on how the range was split: results are bit-identical
+//      from 1 to any number of threads.  Compile with -fopenmp (see
+//      make_mc_pi_scaling); without it the engine runs on one thread.
+//
+//******************************************************************
+
+#include <cstdlib>
+#include <cmath>
+#include <iomanip>
+using namespace std;
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "mc_pi.hpp"
+#include "pi_kernel.hpp"
+
+//********************************************************************
+void
+RandSource::fill (long long n, double x[], double y[])
+{
+  double max = (double) RAND_MAX;
+  for (long long k = 0; k < n; k++)
+  {
+    x[k] = rand () / max;
+    y[k] = rand () / max;
+  }
+}
+
+void
+RandSource::seek (unsigned long long)
+{
+  cerr << "RandSource::seek - rand() cannot seek; use CounterSource" << endl;
+  exit (1);
+}
+
+PointSource *
+RandSource::clone () const
+{
+  cerr << "RandSource::clone - rand() has a single global state" << endl;
+  exit (1);
+  return (0);
+}
+
+//********************************************************************
+CounterSource::CounterSource (unsigned long long seed)
+  : key (mix64 (seed + 0x9e3779b97f4a7c15ULL)), index (0)
+{
+}
+
+void
+CounterSource::fill (long long n, double x[], double y[])
+{
+  for (long long k = 0; k < n; k++)
+  {
+    unsigned long long c = 2 * (index + k);	// two counters per point
+    x[k] = to_unit (mix64 (key ^ mix64 (c)));
+    y[k] = to_unit (mix64 (key ^ mix64 (c + 1)));
+  }
+  index += n;
+}
+
+//********************************************************************
+static HaltonStream
+halton_xy (int ba, int bb)
+{
+  int b[2] = { ba, bb };
+  return (HaltonStream (2, b));
+}
+
+HaltonSource::HaltonSource (int ba, int bb) : stream (halton_xy (ba, bb))
+{
+}
+
+void
+HaltonSource::fill (long long n, double x[], double y[])
+{
+  double *xy[2] = { x, y };
+  stream.fill (n, xy);
+}
+
+//********************************************************************
+long long
+count_in_circle (long long n, const double x[], const double y[])
+{
+  // scalar, AVX2 or AVX-512, whichever this CPU supports (pi_kernel.cpp)
+  return (pi_kernel_select () (n, x, y));
+}
+
+//********************************************************************
+void
+pi_update (PiEstimate &est)
+{
+  if (est.n <= 0)
+  {
+    est.pi = 0.;
+    est.std_err = 0.;
+    return;
+  }
+  double p = double (est.inside) / double (est.n);
+  est.pi = 4. * p;
+  est.std_err = 4. * sqrt (p * (1. - p) / double (est.n));
+}
+
+//********************************************************************
+PiEstimate
+mc_pi_stream (PointSource &src, long long N, long long checkpoint,
+              double factor, ostream &out)
+{
+  double x[mc_pi_block];
+  double y[mc_pi_block];
+
+  PiEstimate est = { 0, 0, 0., 0. };
+
+  if (checkpoint < 1)
+  {
+    checkpoint = N;
+  }
+  if (factor <= 1.)
+  {
+    factor = 2.;
+  }
+
+  while (est.n < N)
+  {
+    // never run past the next checkpoint, so each report is exact at n
+    long long stop = (checkpoint < N ? checkpoint : N);
+    long long nb = stop - est.n;
+    if (nb > mc_pi_block)
+    {
+      nb = mc_pi_block;
+    }
+
+    src.fill (nb, x, y);
+    est.inside += count_in_circle (nb, x, y);
+    est.n += nb;
+
+    if (est.n == stop)
+    {
+      pi_update (est);
+      streamsize old_precision = out.precision ();
+      out << "Pi approx by " << src.name () << ": " << setprecision (8)
+          << est.pi << " +/- " << setprecision (2) << est.std_err
+          << " using " << est.n << " iterations" << endl;
+      out.precision (old_precision);
+
+      // next checkpoint, rounded like the old N *= 2.5 loop
+      while (checkpoint <= est.n)
+      {
+        long long next = (long long) (checkpoint * factor);
+        checkpoint = (next > checkpoint ? next : checkpoint + 1);
+      }
+    }
+  }
+  pi_update (est);
+  return (est);
+}
+
+//********************************************************************
+PiEstimate
+mc_pi_parallel (const PointSource &src, unsigned long long i0, long long N,
+                int nthreads)
+{
+  long long inside = 0;
+
+#ifdef _OPENMP
+  if (nthreads <= 0)
+  {
+    nthreads = omp_get_max_threads ();
+  }
+  #pragma omp parallel num_threads(nthreads) reduction(+:inside)
+#else
+  (void) nthreads;		// serial build: one "thread" does everything
+#endif
+  {
+#ifdef _OPENMP
+    long long t = omp_get_thread_num ();
+    long long T = omp_get_num_threads ();
+#else
+    long long t = 0;
+    long long T = 1;
+#endif
+    // this thread's share of the indices; N*T stays far below 2^63
+    long long begin = N / T * t + (N % T) * t / T;
+    long long end = N / T * (t + 1) + (N % T) * (t + 1) / T;
+
+    double x[mc_pi_block];
+    double y[mc_pi_block];
+
+    PointSource *my_src = src.clone ();
+    my_src->seek (i0 + (unsigned long long) begin);
+
+    for (long long k = begin; k < end; k += mc_pi_block)
+    {
+      long long nb = (end - k < mc_pi_block ? end - k : mc_pi_block);
+      my_src->fill (nb, x, y);
+      inside += count_in_circle (nb, x, y);
+    }
+    delete my_src;
+  }
+
+  PiEstimate est = { N, inside, 0., 0. };
+  pi_update (est);
+  return (est);
+}
@@ -0,0 +1,124 @@
+//  file: mc_pi.hpp
+//
+//  Header file for the streaming Monte Carlo estimate of pi: sources of
+//   points in the unit square and a driver that counts how many land in
+//   the quarter circle without ever storing the whole sequence.
+//
+//  Revision history:
+//   08/05/21  original version, replaces randseq() and omc()
+//   10/05/21  added seek/clone, CounterSource and the OpenMP engine
+//
+#ifndef MC_PI_HPP
+#define MC_PI_HPP
+
+#include <iostream>
+#include <string>
+
+#include "halton_stream.hpp"
+
+// SplitMix64 finalizer: a bijective 64-bit mix with good avalanche, used
+//  as a counter-based generator (hash of seed and index)
+inline unsigned long long
+mix64 (unsigned long long z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return (z ^ (z >> 31));
+}
+
+// top 53 bits of a 64-bit integer as a double in [0,1)
+inline double
+to_unit (unsigned long long u)
+{
+  return (double (u >> 11) * (1.0 / 9007199254740992.0));
+}
+
+// Anything that can hand out points (x,y) in [0,1)^2 a block at a time
+class PointSource
+{
+public:
+  virtual ~PointSource () {};
+
+  // x[k], y[k] = the next n points, 0 <= k < n
+  virtual void fill (long long n, double x[], double y[]) = 0;
+
+  // make the next point the one with index i (0 = start of the sequence)
+  virtual void seek (unsigned long long i) = 0;
+
+  // independent copy at the same position, for use by another thread
+  virtual PointSource *clone () const = 0;
+
+  virtual std::string name () const = 0;	// label used in the output
+};
+
+// Pseudo-random points from rand()/RAND_MAX, as randseq() used to make.
+//  rand() has one hidden global state, so this source cannot seek or be
+//  cloned and is only usable from mc_pi_stream().
+class RandSource : public PointSource
+{
+public:
+  void fill (long long n, double x[], double y[]);
+  void seek (unsigned long long i);
+  PointSource *clone () const;
+  std::string name () const { return "original MC"; };
+};
+
+// Counter-based pseudo-random points: point i is a hash of (seed, i), so
+//  any index can be reached at once and a run is fixed by its seed.
+class CounterSource : public PointSource
+{
+public:
+  CounterSource (unsigned long long seed);
+  void fill (long long n, double x[], double y[]);
+  void seek (unsigned long long i) { index = i; };
+  PointSource *clone () const { return new CounterSource (*this); };
+  std::string name () const { return "counter MC"; };
+
+private:
+  unsigned long long key;	// seed, mixed once
+  unsigned long long index;	// index of the next point
+};
+
+// Halton points, x in base ba and y in base bb
+class HaltonSource : public PointSource
+{
+public:
+  HaltonSource (int ba, int bb);
+  void fill (long long n, double x[], double y[]);
+  void seek (unsigned long long i) { stream.seek (i); };
+  PointSource *clone () const { return new HaltonSource (*this); };
+  std::string name () const { return "Halton  MC"; };
+
+private:
+  HaltonStream stream;
+};
+
+// running result of the estimate
+struct PiEstimate
+{
+  long long n;			// points used so far
+  long long inside;		// points with x^2 + y^2 < 1
+  double pi;			// 4 * inside / n
+  double std_err;		// binomial standard error of pi
+};
+
+// number of points k < n with x[k]^2 + y[k]^2 < 1
+long long count_in_circle (long long n, const double x[], const double y[]);
+
+// fills in pi and std_err from n and inside
+void pi_update (PiEstimate &est);
+
+// Draw N points from src in blocks of mc_pi_block and report the running
+//  estimate to out at n = checkpoint, checkpoint*factor, ... and at N.
+PiEstimate mc_pi_stream (PointSource &src, long long N, long long checkpoint,
+                         double factor, std::ostream &out);
+
+// Count points i0 .. i0+N-1 of src on nthreads OpenMP threads (0 = all).
+//  Each thread clones src and seeks to the start of its own index range,
+//  so the count, and hence pi, is identical for any number of threads.
+PiEstimate mc_pi_parallel (const PointSource &src, unsigned long long i0,
+                           long long N, int nthreads);
+
+const long long mc_pi_block = 2048;	// points per block (2 x 16 kB buffers)
+
+#endif
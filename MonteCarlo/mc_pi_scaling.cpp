@@ -0,0 +1,86 @@
+//  file: mc_pi_scaling.cpp
+//
+//  Strong-scaling report for the OpenMP Monte Carlo pi engine.  The same
+//   N points are counted on 1, 2, ... max_threads threads for both the
+//   counter-based pseudo-random source and the Halton source; the
+//   count must come out identical every time.
+//
+//  Revision history:
+//   10/05/21  original version
+//
+//  Notes:
+//   * compile with make -f make_mc_pi_scaling (needs -fopenmp)
+//   * the default thread count is omp_get_num_procs(); asking for more
+//      than that oversubscribes the cores and the speedup flattens
+//
+//*********************************************************************//
+
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <omp.h>
+
+#include "mc_pi.hpp"
+
+void scaling_run (const PointSource &src, long long N, int max_threads);
+
+//*********************************************************************//
+int
+main (void)
+{
+  long long N;
+  unsigned long long seed;
+  int max_threads = omp_get_num_procs ();
+
+  cout << "Number of points N: ";
+  cin >> N;
+  cout << "Seed for the counter-based source: ";
+  cin >> seed;
+  cout << "Maximum number of threads (0 = " << max_threads << "): ";
+  int requested;
+  cin >> requested;
+  if (requested > 0)
+  {
+    max_threads = requested;
+  }
+
+  CounterSource cs (seed);
+  HaltonSource hs (2, 3);
+
+  scaling_run (cs, N, max_threads);
+  scaling_run (hs, N, max_threads);
+
+  return 0;
+}
+
+//*********************************************************************//
+void
+scaling_run (const PointSource &src, long long N, int max_threads)
+{
+  double t1 = 0.;
+  long long inside1 = 0;
+
+  cout << endl << src.name () << ", N = " << N << endl;
+  cout << "# threads    time(s)   speedup  efficiency        pi"
+       << "          inside  same" << endl;
+
+  for (int T = 1; T <= max_threads; T++)
+  {
+    double start = omp_get_wtime ();
+    PiEstimate est = mc_pi_parallel (src, 0, N, T);
+    double end = omp_get_wtime ();
+
+    double t = end - start;
+    if (T == 1)
+    {
+      t1 = t;
+      inside1 = est.inside;
+    }
+    cout << fixed << setw (9) << T << "  " << setprecision (4) << setw (9) << t
+         << "  " << setprecision (2) << setw (8) << t1 / t
+         << "  " << setw (10) << t1 / t / T
+         << "  " << setprecision (8) << setw (10) << est.pi
+         << "  " << setw (14) << est.inside
+         << "  " << (est.inside == inside1 ? "yes" : "NO") << endl;
+  }
+}
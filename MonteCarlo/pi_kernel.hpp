@@ -0,0 +1,32 @@
+//  file: pi_kernel.hpp
+//
+//  Header file for the in-circle counting kernels used by the Monte Carlo
+//   pi drivers: a portable scalar loop plus AVX2 and AVX-512 versions,
+//   with the fastest one the CPU supports picked at run time.
+//
+//  Revision history:
+//   12/05/21  original version
+//
+#ifndef PI_KERNEL_HPP
+#define PI_KERNEL_HPP
+
+// number of points k < n with x[k]^2 + y[k]^2 < 1 (x and y are SoA)
+typedef long long (*pi_kernel_t) (long long n, const double x[],
+                                  const double y[]);
+
+long long count_in_circle_scalar (long long n, const double x[],
+                                  const double y[]);
+long long count_in_circle_avx2 (long long n, const double x[],
+                                const double y[]);
+long long count_in_circle_avx512 (long long n, const double x[],
+                                  const double y[]);
+
+// the kernel chosen for this CPU, and its name ("avx512", "avx2", "scalar")
+pi_kernel_t pi_kernel_select ();
+const char *pi_kernel_name ();
+
+// availability of the vector kernels on this CPU/compiler
+bool pi_kernel_has_avx2 ();
+bool pi_kernel_has_avx512 ();
+
+#endif
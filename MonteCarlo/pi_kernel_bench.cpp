@@ -0,0 +1,143 @@
+//  file: pi_kernel_bench.cpp
+//
+//  Microbenchmark of the in-circle counting kernels against the original
+//   omc() loop (pow() twice and a branch per point, interleaved x/y).
+//   Each kernel is run on a buffer that fits in L1 and on one that does
+//   not, and the time per point and points per cycle are printed.
+//
+//  Revision history:
+//   12/05/21  original version
+//   14/05/21  switched to the Benchmark harness
+//
+//  Notes:
+//   * cycles are read with rdtsc, which counts at the nominal clock; with
+//      turbo enabled the true points/cycle are somewhat lower
+//   * compile with make -f make_pi_kernel_bench; timings go through the
+//      Benchmark harness and are also written to pi_kernel_bench.csv
+//
+//*********************************************************************//
+
+#include <iostream>
+#include <fstream>
+#include <cmath>
+using namespace std;
+
+#include "mc_pi.hpp"
+#include "pi_kernel.hpp"
+#include "bench_timer.hpp"
+
+double omc_legacy (int N, double *seq);	// copy of the old omc() loop
+
+//*********************************************************************//
+int
+main (void)
+{
+  const long long n_small = 1024;	// 16 kB of points: L1 resident
+  const long long n_large = 1 << 24;	// 256 MB of points: memory bound
+  const long long total = 20000000;	// points per timed trial
+
+  double *x = new double[n_large];
+  double *y = new double[n_large];
+  double *seq = new double[2 * n_large + 1];
+
+  CounterSource src (2021);
+  src.fill (n_large, x, y);
+  for (long long k = 0; k < n_large; k++)
+  {
+    seq[2 * k] = x[k];
+    seq[2 * k + 1] = y[k];
+  }
+  seq[2 * n_large] = 0.;
+
+  // read through volatile pointers so the compiler cannot hoist the
+  //  (pure) kernel calls out of the repetition loops
+  double *volatile xv = x;
+  double *volatile yv = y;
+  double *volatile seqv = seq;
+
+  cout << "selected kernel: " << pi_kernel_name () << endl << endl;
+
+  Benchmark bench (2, 15);
+  const long long sizes[2] = { n_small, n_large };
+  for (int s = 0; s < 2; s++)
+  {
+    long long n = sizes[s];
+    long long reps = (total / n > 1 ? total / n : 1);
+    string suffix = (s == 0 ? " L1" : " mem");
+
+    // each trial sweeps the buffer reps times; "value" is the mean count
+    bench.run ("omc()" + suffix, n * reps, [&] () {
+      double pi = 0.;
+      for (long long r = 0; r < reps; r++)
+      {
+        pi += omc_legacy (int (n), seqv);
+      }
+      return floor (pi / double (reps) * double (n) / 4. + 0.5);
+    });
+    bench.run ("scalar" + suffix, n * reps, [&] () {
+      long long c = 0;
+      for (long long r = 0; r < reps; r++)
+      {
+        c += count_in_circle_scalar (n, xv, yv);
+      }
+      return double (c / reps);
+    });
+    if (pi_kernel_has_avx2 ())
+    {
+      bench.run ("avx2" + suffix, n * reps, [&] () {
+        long long c = 0;
+        for (long long r = 0; r < reps; r++)
+        {
+          c += count_in_circle_avx2 (n, xv, yv);
+        }
+        return double (c / reps);
+      });
+    }
+    if (pi_kernel_has_avx512 ())
+    {
+      bench.run ("avx512" + suffix, n * reps, [&] () {
+        long long c = 0;
+        for (long long r = 0; r < reps; r++)
+        {
+          c += count_in_circle_avx512 (n, xv, yv);
+        }
+        return double (c / reps);
+      });
+    }
+  }
+  bench.print (cout);
+
+  // points per cycle is the inverse of cycles/sample
+  const vector<BenchResult> &res = bench.get_results ();
+  cout << endl << "# name          points/cycle" << endl;
+  for (size_t i = 0; i < res.size (); i++)
+  {
+    cout << "  " << res[i].name << "\t"
+         << (res[i].cycles_per_sample > 0. ? 1. / res[i].cycles_per_sample : 0.)
+         << endl;
+  }
+
+  ofstream csv ("pi_kernel_bench.csv");
+  bench.write_csv (csv);
+
+  delete[] x;
+  delete[] y;
+  delete[] seq;
+  return 0;
+}
+
+//*********************************************************************//
+double
+omc_legacy (int N, double *seq)
+{
+  double pi;
+  int inc = 0; // the count of tries 'in circle'
+
+  for (int i = 0; i < N; ++i) {
+    if (pow(seq[i], 2) + pow(seq[i+1], 2) < 1) {
+      ++inc;
+    }
+  }
+  pi = 4.0 * inc / N;
+  return(pi);
+}
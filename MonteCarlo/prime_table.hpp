@@ -0,0 +1,58 @@
+//  file: prime_table.hpp
+//
+//  Compile-time table of the first PRIME_TABLE_MAX primes and their
+//   reciprocals, shared by prime() and the Halton routines.
+//
+//  prime() used to declare its 1600-entry list as a local array, so every
+//   call copied the whole list onto the stack, and halton_sequence() made
+//   three such calls per digit.  The table is now built once by the
+//   compiler (constexpr trial division, C++14 or later) and read directly.
+//
+//  Revision history:
+//   18/05/21  original version
+//
+#ifndef PRIME_TABLE_HPP
+#define PRIME_TABLE_HPP
+
+#define PRIME_TABLE_MAX 1600	// same limit as PRIME_MAX in prime()
+
+struct PrimeTable
+{
+  int p[PRIME_TABLE_MAX];	// p[k] = prime number k+1 (p[0] = 2)
+  double inv[PRIME_TABLE_MAX];	// inv[k] = 1.0 / p[k], correctly rounded
+};
+
+constexpr PrimeTable
+make_prime_table ()
+{
+  PrimeTable t = {};
+  int count = 0;
+
+  for (int c = 2; count < PRIME_TABLE_MAX; c++)
+  {
+    bool is_prime = true;
+    for (int k = 0; k < count && t.p[k] * t.p[k] <= c; k++)
+    {
+      if (c % t.p[k] == 0)
+      {
+        is_prime = false;
+        break;
+      }
+    }
+    if (is_prime)
+    {
+      t.p[count] = c;
+      t.inv[count] = 1.0 / double (c);
+      count++;
+    }
+  }
+  return (t);
+}
+
+constexpr PrimeTable prime_table = make_prime_table ();
+
+static_assert (prime_table.p[0] == 2 && prime_table.p[99] == 541
+               && prime_table.p[PRIME_TABLE_MAX - 1] == 13499,
+               "prime_table does not match the list prime() used to hold");
+
+#endif
@@ -0,0 +1,122 @@
+//  file: qmc_integration_test.cpp
+//
+//  Compares plain Monte Carlo with randomized quasi-Monte Carlo (Halton,
+//   scrambled Halton, Sobol') on two 10-dimensional integrals over the
+//   unit hypercube with known values (and the second again in 20
+//   dimensions), and estimates pi from the first two Sobol' coordinates
+//   through the usual pi driver.
+//
+//  Revision history:
+//   16/05/21  original version
+//
+//  Notes:
+//   * the integrands have the gsl_monte_function signature:
+//       (sum x_j)^2              exact 155/6 for d = 10 (as in
+//                                 gsl_monte_carlo_test.cpp)
+//       prod (|4x_j-2|+a_j)/(1+a_j), a_j = j   exact 1 (Sobol' g-function)
+//   * every row uses the same total number of points; the error bar is
+//      the standard error over the independent replicas.  The last column
+//      is (MC error / this error)^2, i.e. how many times more points plain
+//      MC would need for the same error.
+//   * compile with make -f make_qmc_integration_test
+//
+//*********************************************************************//
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+using namespace std;
+
+#include "qmc_sequence.hpp"
+#include "mc_pi.hpp"
+
+double sum_squared (double *x, size_t dim, void *params);
+double g_function (double *x, size_t dim, void *params);
+void compare (const char *label, qmc_integrand f, double exact, int dim);
+
+//*********************************************************************//
+int
+main (void)
+{
+  const int dim = 10;
+
+  compare ("(sum x)^2", sum_squared, 155. / 6., dim);
+  compare ("g-function", g_function, 1., dim);
+  compare ("g-function", g_function, 1., 2 * dim);	// where plain Halton degrades
+
+  // the same interface feeds the pi driver
+  SobolGenerator sobol (2);
+  sobol.randomize (2021);
+  QmcSource src (sobol);
+  cout << endl;
+  mc_pi_stream (src, 1 << 20, 1 << 10, 4., cout);
+
+  return 0;
+}
+
+//*********************************************************************//
+// Integrate f with each generator at several n and print the errors
+void
+compare (const char *label, qmc_integrand f, double exact, int dim)
+{
+  const int replicas = 16;
+  PseudoRandomGenerator mc (dim);
+  HaltonGenerator halton (dim);
+  HaltonGenerator scrambled (dim, true);
+  SobolGenerator sobol (dim);
+  const QmcGenerator *gens[4] = { &mc, &halton, &scrambled, &sobol };
+
+  cout << endl << label << " in d = " << dim << ", exact = "
+       << setprecision (10) << exact << ", " << replicas << " replicas"
+       << endl;
+  cout << "# generator               n      estimate     std err"
+       << "   |error|  MC pts/pts" << endl;
+
+  for (int p = 10; p <= 16; p += 2)
+  {
+    long long n = 1LL << p;
+    double mc_err = 0.;
+    for (int g = 0; g < 4; g++)
+    {
+      QmcResult res = qmc_integrate (*gens[g], f, 0, n, replicas, 12345);
+      if (g == 0)
+      {
+        mc_err = res.std_err;
+      }
+      cout << "  " << left << setw (18) << gens[g]->name () << right
+           << setw (8) << n * replicas << fixed << setprecision (6)
+           << setw (14) << res.mean << scientific << setprecision (2)
+           << setw (12) << res.std_err << setw (10)
+           << fabs (res.mean - exact) << fixed << setprecision (1)
+           << setw (12)
+           << (res.std_err > 0. ? (mc_err / res.std_err)
+               * (mc_err / res.std_err) : 0.) << endl;
+    }
+  }
+}
+
+//*********************************************************************//
+double
+sum_squared (double *x, size_t dim, void *params)
+{
+  (void) params;
+  double sum = 0.;
+  for (size_t j = 0; j < dim; j++)
+  {
+    sum += x[j];
+  }
+  return (sum * sum);
+}
+
+double
+g_function (double *x, size_t dim, void *params)
+{
+  (void) params;
+  double prod = 1.;
+  for (size_t j = 0; j < dim; j++)
+  {
+    double a = double (j + 1);
+    prod *= (fabs (4. * x[j] - 2.) + a) / (1. + a);
+  }
+  return (prod);
+}
@@ -0,0 +1,156 @@
+//  file: qmc_sequence.hpp
+//
+//  Header file for the low-discrepancy sequence library: plain and
+//   scrambled Halton, Sobol' and (for comparison) counter-based
+//   pseudo-random points, all behind the QmcGenerator interface, plus
+//   randomized QMC integration with replica error bars.
+//
+//  Revision history:
+//   16/05/21  original version
+//
+#ifndef QMC_SEQUENCE_HPP
+#define QMC_SEQUENCE_HPP
+
+#include <string>
+#include <vector>
+
+#include "halton_stream.hpp"
+#include "mc_pi.hpp"
+
+// A sequence of points in [0,1)^m
+class QmcGenerator
+{
+public:
+  virtual ~QmcGenerator () {};
+
+  virtual int get_dim () const = 0;	// spatial dimension m
+
+  // r[0..m-1] = the next point
+  virtual void next (double r[]) = 0;
+
+  // r[j][k] = coordinate j of the next n points (SoA); the default just
+  //  calls next() n times
+  virtual void fill (long long n, double *r[]);
+
+  // make the next point the one with index i (0 = start of the sequence)
+  virtual void seek (unsigned long long i) = 0;
+
+  // independent copy at the same position
+  virtual QmcGenerator *clone () const = 0;
+
+  // Apply a fresh random scrambling/shift fixed by seed and go back to
+  //  index 0.  Every point of a randomized sequence is uniform on [0,1)^m,
+  //  so independent replicas give an unbiased mean and an error bar.
+  virtual void randomize (unsigned long long seed) = 0;
+
+  virtual std::string name () const = 0;	// label used in the output
+};
+
+// Halton points in the first m prime bases, as halton() gives them.
+//  randomize() adds a random Cranley-Patterson shift (mod 1); if scrambled
+//  is set it also draws new random digit permutations, which breaks up the
+//  correlations between the large-prime dimensions.
+class HaltonGenerator : public QmcGenerator
+{
+public:
+  HaltonGenerator (int m, bool scrambled = false);
+  int get_dim () const { return dim; };
+  void next (double r[]);
+  void fill (long long n, double *r[]);
+  void seek (unsigned long long i) { stream.seek (i); };
+  QmcGenerator *clone () const { return new HaltonGenerator (*this); };
+  void randomize (unsigned long long seed);
+  std::string name () const;
+
+private:
+  int dim;
+  bool scrambled;
+  HaltonStream stream;
+  std::vector<double> shift;	// Cranley-Patterson shift, 0 until randomized
+};
+
+// Sobol' points with the Joe-Kuo direction numbers (m <= sobol_max_dim),
+//  generated in Gray-code order with 32-bit integers.  randomize() applies
+//  a random digital shift (XOR of every coordinate with a random 32-bit
+//  mask).  At most 2^32 points can be drawn.
+class SobolGenerator : public QmcGenerator
+{
+public:
+  SobolGenerator (int m);
+  int get_dim () const { return dim; };
+  void next (double r[]);
+  void seek (unsigned long long i);
+  QmcGenerator *clone () const { return new SobolGenerator (*this); };
+  void randomize (unsigned long long seed);
+  std::string name () const { return "Sobol'"; };
+
+  static const int max_dim = 21;	// dimensions with tabulated direction numbers
+  static const int bits = 32;		// bits per coordinate
+
+private:
+  int dim;
+  unsigned long long index;		// index of the next point
+  std::vector<unsigned int> v;		// direction numbers, v[j*bits+k]
+  std::vector<unsigned int> x;		// current point as integers
+  std::vector<unsigned int> mask;	// digital shift, 0 until randomized
+};
+
+// Counter-based pseudo-random points (plain Monte Carlo), coordinate j of
+//  point i is a hash of (seed, i*m+j).  randomize() just changes the seed.
+class PseudoRandomGenerator : public QmcGenerator
+{
+public:
+  PseudoRandomGenerator (int m, unsigned long long seed = 0);
+  int get_dim () const { return dim; };
+  void next (double r[]);
+  void seek (unsigned long long i) { index = i; };
+  QmcGenerator *clone () const { return new PseudoRandomGenerator (*this); };
+  void randomize (unsigned long long seed);
+  std::string name () const { return "pseudo-random"; };
+
+private:
+  int dim;
+  unsigned long long key;	// seed, mixed once
+  unsigned long long index;	// index of the next point
+};
+
+// Adapter that lets any generator with m >= 2 feed the pi driver
+//  (mc_pi_stream, mc_pi_parallel); x and y are the first two coordinates.
+class QmcSource : public PointSource
+{
+public:
+  QmcSource (const QmcGenerator &g);
+  QmcSource (const QmcSource &other);
+  ~QmcSource ();
+  void fill (long long n, double x[], double y[]);
+  void seek (unsigned long long i) { gen->seek (i); };
+  PointSource *clone () const { return new QmcSource (*this); };
+  std::string name () const { return gen->name (); };
+
+private:
+  QmcSource &operator= (const QmcSource &);	// not assignable
+  QmcGenerator *gen;	// owned copy
+};
+
+// Integrand with the same signature as gsl_monte_function's f, so the
+//  functions written for the GSL integrators can be used unchanged
+typedef double (*qmc_integrand) (double *x, size_t dim, void *params);
+
+// result of qmc_integrate()
+struct QmcResult
+{
+  double mean;		// average of the replica means
+  double std_err;	// standard deviation of the replica means / sqrt(replicas)
+  long long n;		// points per replica
+  int replicas;		// number of independent randomizations
+};
+
+// Integrate f over [0,1)^m with n points from each of `replicas`
+//  independent randomizations of gen (m = gen.get_dim()).  The replica
+//  seeds are derived from seed, so a run is reproducible.  With fewer than
+//  two replicas std_err is 0.
+QmcResult qmc_integrate (const QmcGenerator &gen, qmc_integrand f,
+                         void *params, long long n, int replicas,
+                         unsigned long long seed);
+
+#endif
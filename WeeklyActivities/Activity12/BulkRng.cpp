@@ -0,0 +1,452 @@
+//  file: BulkRng.cpp
+//
+//  Member functions for BulkRng class that generates arrays of random
+//   numbers
+//
+//  Revision history:
+//      06/02/21  original version
+//      06/04/21  Ziggurat gaussian and exponential numbers
+//
+//  Notes:
+//   * xoshiro256+ (Blackman and Vigna), the same generator and [1,2)
+//      exponent trick as in RandomWalkEnsemble.cpp.  The state is copied
+//      into local arrays for each call, so the compiler keeps it in
+//      vector registers.
+//   * a request for n numbers that is not a multiple of `lanes' uses
+//      one extra round of the generators and throws the rest away.
+//   * Box-Muller: for u1 in (0,1] and u2 in [0,1),
+//      r = sigma sqrt(-2 ln u1), g1 = r cos(2 pi u2), g2 = r sin(2 pi u2)
+//      are two independent gaussian numbers.  The u1's and u2's of a
+//      block are made first and the transformation is a separate loop,
+//      which gcc turns into calls to the vector log, sin and cos of
+//      libmvec with -ffast-math (and into scalar calls without it).
+//   * Ziggurat: the area under f(x) = exp(-x^2/2) (or exp(-x)) is
+//      covered by 255 rectangles [0,x[i]] x [f(x[i]),f(x[i+1])] and a
+//      base strip (layer 0) of the same area V, which includes the tail
+//      beyond x[1] = R.  A 64-bit number gives the layer i (low 8 bits),
+//      the sign (bit 8) and u in [0,1) (top 52 bits); x = u x[i] is
+//      accepted at once if u < x[i+1]/x[i].  Otherwise x is in the wedge
+//      above f, which takes an extra uniform number, or in the tail
+//      (Marsaglia's method for the gaussian tail; R + an exponential
+//      for the exponential).  The tables follow Doornik's ZIGNOR, with
+//      x[0] = V/f(R) so that the layer-0 test needs no special case.
+//   * the random numbers for a block come from fill(); the loop over
+//      them is scalar (gcc does not use gathers for the table lookups),
+//      so the sign is made without a branch, which would be mispredicted
+//      half the time.  The rare cases take more numbers from next_word().
+//
+//******************************************************************
+
+// include files
+#include <cmath>
+#include <cstring>
+
+#include "BulkRng.h"
+
+//********************************************************************
+// SplitMix64 generator, used only to fill the first xoshiro state
+static inline uint64_t
+splitmix64 (uint64_t &z)
+{
+  uint64_t r = (z += 0x9e3779b97f4a7c15ULL);
+  r = (r ^ (r >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  r = (r ^ (r >> 27)) * 0x94d049bb133111ebULL;
+  return (r ^ (r >> 31));
+}
+
+static inline uint64_t
+rotl (uint64_t v, int k)
+{
+  return ((v << k) | (v >> (64 - k)));
+}
+
+// one xoshiro256+ step of s[0..3]
+static inline uint64_t
+next (uint64_t s[4])
+{
+  uint64_t result = s[0] + s[3];
+  uint64_t t = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl (s[3], 45);
+  return (result);
+}
+
+// advance s[0..3] by 2^128 steps
+static void
+jump (uint64_t s[4])
+{
+  static const uint64_t jump_poly[4] = {
+    0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+    0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+  };
+  uint64_t t[4] = { 0, 0, 0, 0 };
+  for (int w = 0; w < 4; w++)
+  {
+    for (int b = 0; b < 64; b++)
+    {
+      if (jump_poly[w] & (1ULL << b))
+      {
+        for (int k = 0; k < 4; k++)
+        {
+          t[k] ^= s[k];
+        }
+      }
+      next (s);
+    }
+  }
+  for (int k = 0; k < 4; k++)
+  {
+    s[k] = t[k];
+  }
+}
+
+// u in [1,2) from the top 52 bits of a random number, by setting the
+//  exponent bits
+static inline double
+to_unit (uint64_t r)
+{
+  uint64_t bits = (r >> 12) | 0x3ff0000000000000ULL;
+  double u;
+  memcpy (&u, &bits, sizeof (u));
+  return (u);
+}
+
+// a random number as it is, or made into a double in [1,2)
+static inline void
+store (uint64_t r, uint64_t &out)
+{
+  out = r;
+}
+
+static inline void
+store (uint64_t r, double &out)
+{
+  out = to_unit (r);
+}
+
+// one xoshiro256+ step of each of the `lanes' states in s0[], ..., s3[],
+//  the numbers put in out[0..lanes-1]
+template <class T>
+static inline void
+next_round (uint64_t s0[], uint64_t s1[], uint64_t s2[], uint64_t s3[],
+            T out[])
+{
+  // without this gcc unrolls the loop completely and then finds the
+  //  straight-line code not worth vectorizing
+#pragma GCC unroll 1
+  for (int l = 0; l < BulkRng::lanes; l++)
+  {
+    uint64_t r = s0[l] + s3[l];
+    uint64_t tmp = s1[l] << 17;
+    s2[l] ^= s0[l];
+    s3[l] ^= s1[l];
+    s1[l] ^= s2[l];
+    s0[l] ^= s3[l];
+    s2[l] ^= tmp;
+    s3[l] = rotl (s3[l], 45);
+    store (r, out[l]);
+  }
+}
+
+//********************************************************************
+// Constructor for BulkRng: lane l gets the seeded state jumped l times
+BulkRng::BulkRng (unsigned long int seed)
+{
+  uint64_t z = seed;
+  uint64_t s[4];
+  for (int k = 0; k < 4; k++)
+  {
+    s[k] = splitmix64 (z);
+  }
+  for (int l = 0; l < lanes; l++)
+  {
+    s0[l] = s[0];
+    s1[l] = s[1];
+    s2[l] = s[2];
+    s3[l] = s[3];
+    jump (s);
+  }
+}
+
+//********************************************************************
+// Fill out[0..n-1] with 64-bit random numbers (T = uint64_t) or with
+//  numbers in [1,2) (T = double)
+template <class T>
+void
+BulkRng::fill (T *out, long n)
+{
+  uint64_t t0[lanes], t1[lanes], t2[lanes], t3[lanes];
+  for (int l = 0; l < lanes; l++)
+  {
+    t0[l] = s0[l];
+    t1[l] = s1[l];
+    t2[l] = s2[l];
+    t3[l] = s3[l];
+  }
+
+  long i = 0;
+  for (; i + lanes <= n; i += lanes)
+  {
+    next_round (t0, t1, t2, t3, out + i);
+  }
+  if (i < n)
+  {				// last, partial round
+    T tail[lanes];
+    next_round (t0, t1, t2, t3, tail);
+    for (int l = 0; l < n - i; l++)
+    {
+      out[i + l] = tail[l];
+    }
+  }
+
+  for (int l = 0; l < lanes; l++)
+  {
+    s0[l] = t0[l];
+    s1[l] = t1[l];
+    s2[l] = t2[l];
+    s3[l] = t3[l];
+  }
+}
+
+//********************************************************************
+// u[0..n-1] uniform in [lower,upper)
+void
+BulkRng::uniform (double *u, long n, double lower, double upper)
+{
+  fill (u, n);
+  const double width = upper - lower;
+  const double offset = lower - width;	// [1,2) -> [lower,upper)
+  for (long i = 0; i < n; i++)
+  {
+    u[i] = offset + width * u[i];
+  }
+}
+
+// g[0..n-1] gaussian with standard deviation sigma, by Box-Muller on
+//  blocks of pairs
+void
+BulkRng::gaussian (double *g, long n, double sigma)
+{
+  const int block = 256;	// pairs per block
+  double u[2 * block];
+  double r[block], phi[block];
+  double out[2 * block];
+  for (long i = 0; i < n; i += 2 * block)
+  {
+    long m = (n - i < 2 * block ? n - i : 2 * block);
+    int pairs = int ((m + 1) / 2);
+    fill (u, 2 * pairs);
+    for (int j = 0; j < pairs; j++)
+    {
+      r[j] = sigma * sqrt (-2. * log (2. - u[j]));	// 2 - u in (0,1]
+      phi[j] = 2. * M_PI * (u[pairs + j] - 1.);
+    }
+    // separate loops, or gcc makes one sincos call, which has no
+    //  vector version
+    for (int j = 0; j < pairs; j++)
+    {
+      out[j] = r[j] * cos (phi[j]);
+    }
+    for (int j = 0; j < pairs; j++)
+    {
+      out[pairs + j] = r[j] * sin (phi[j]);
+    }
+    for (long j = 0; j < m; j++)
+    {
+      g[i + j] = out[j];
+    }
+  }
+}
+
+//********************************************************************
+// Tables for the Ziggurats with 256 layers
+struct ZigguratTables
+{
+  double xn[257], rn[256], fn[257];	// gaussian
+  double xe[257], re[256], fe[257];	// exponential
+
+  ZigguratTables ()
+  {
+    const double rn_tail = 3.6541528853610088;	// R and V for the gaussian
+    const double vn = 0.00492867323399;
+    double f = exp (-0.5 * rn_tail * rn_tail);
+    xn[0] = vn / f;
+    xn[1] = rn_tail;
+    for (int i = 1; i < 255; i++)
+    {
+      xn[i + 1] = sqrt (-2. * log (vn / xn[i] + f));
+      f = exp (-0.5 * xn[i + 1] * xn[i + 1]);
+    }
+    xn[256] = 0.;
+
+    const double re_tail = 7.69711747013104972;	// and for the exponential
+    const double ve = 0.0039496598225815571993;
+    f = exp (-re_tail);
+    xe[0] = ve / f;
+    xe[1] = re_tail;
+    for (int i = 1; i < 255; i++)
+    {
+      xe[i + 1] = -log (ve / xe[i] + f);
+      f = exp (-xe[i + 1]);
+    }
+    xe[256] = 0.;
+
+    for (int i = 0; i < 256; i++)
+    {
+      rn[i] = xn[i + 1] / xn[i];
+      re[i] = xe[i + 1] / xe[i];
+    }
+    for (int i = 0; i <= 256; i++)
+    {
+      fn[i] = exp (-0.5 * xn[i] * xn[i]);
+      fe[i] = exp (-xe[i]);
+    }
+  };
+};
+
+// made once, on first use (thread-safe in C++11)
+static const ZigguratTables &
+ziggurat ()
+{
+  static const ZigguratTables tables;
+  return (tables);
+}
+
+// One step of lane 0 alone
+uint64_t
+BulkRng::next_word ()
+{
+  uint64_t s[4] = { s0[0], s1[0], s2[0], s3[0] };
+  uint64_t r = next (s);
+  s0[0] = s[0];
+  s1[0] = s[1];
+  s2[0] = s[2];
+  s3[0] = s[3];
+  return (r);
+}
+
+//********************************************************************
+// g[0..n-1] gaussian with standard deviation sigma, by the Ziggurat
+void
+BulkRng::ziggurat_gaussian (double *g, long n, double sigma)
+{
+  const ZigguratTables &t = ziggurat ();
+  const int block = 512;
+  uint64_t r[block];
+  for (long i = 0; i < n; i += block)
+  {
+    int m = int (n - i < block ? n - i : block);
+    fill (r, m);
+    for (int j = 0; j < m; j++)
+    {
+      int layer = int (r[j] & 255);
+      double u = to_unit (r[j]) - 1.;
+      if (u < t.rn[layer])
+      {				// inside the rectangle
+        double sign = 1. - double ((r[j] >> 7) & 2);	// no branch
+        g[i + j] = sign * sigma * u * t.xn[layer];
+      }
+      else
+      {
+        g[i + j] = sigma * gaussian_slow (r[j]);
+      }
+    }
+  }
+}
+
+// A gaussian number (sigma = 1) that starts with the random number r
+//  outside the rectangles
+double
+BulkRng::gaussian_slow (uint64_t r)
+{
+  const ZigguratTables &t = ziggurat ();
+  for (;;)
+  {
+    int layer = int (r & 255);
+    double u = to_unit (r) - 1.;
+    double sign = ((r & 256) ? -1. : 1.);
+    if (u < t.rn[layer])
+    {
+      return (sign * u * t.xn[layer]);
+    }
+    if (layer == 0)
+    {				// tail beyond R
+      double x, y;
+      do
+      {
+        x = -log (2. - to_unit (next_word ())) / t.xn[1];
+        y = -log (2. - to_unit (next_word ()));
+      }
+      while (y + y < x * x);
+      return (sign * (t.xn[1] + x));
+    }
+    double x = u * t.xn[layer];	// in the wedge?
+    double y = t.fn[layer]
+      + (to_unit (next_word ()) - 1.) * (t.fn[layer + 1] - t.fn[layer]);
+    if (y < exp (-0.5 * x * x))
+    {
+      return (sign * x);
+    }
+    r = next_word ();		// rejected: start over
+  }
+}
+
+// e[0..n-1] exponential with mean mu, by the Ziggurat
+void
+BulkRng::exponential (double *e, long n, double mu)
+{
+  const ZigguratTables &t = ziggurat ();
+  const int block = 512;
+  uint64_t r[block];
+  for (long i = 0; i < n; i += block)
+  {
+    int m = int (n - i < block ? n - i : block);
+    fill (r, m);
+    for (int j = 0; j < m; j++)
+    {
+      int layer = int (r[j] & 255);
+      double u = to_unit (r[j]) - 1.;
+      if (u < t.re[layer])
+      {				// inside the rectangle
+        e[i + j] = mu * u * t.xe[layer];
+      }
+      else
+      {
+        e[i + j] = mu * exponential_slow (r[j]);
+      }
+    }
+  }
+}
+
+// An exponential number (mu = 1) that starts with the random number r
+//  outside the rectangles
+double
+BulkRng::exponential_slow (uint64_t r)
+{
+  const ZigguratTables &t = ziggurat ();
+  for (;;)
+  {
+    int layer = int (r & 255);
+    double u = to_unit (r) - 1.;
+    if (u < t.re[layer])
+    {
+      return (u * t.xe[layer]);
+    }
+    if (layer == 0)
+    {				// the tail is R + an exponential
+      return (t.xe[1] - log (2. - to_unit (next_word ())));
+    }
+    double x = u * t.xe[layer];	// in the wedge?
+    double y = t.fe[layer]
+      + (to_unit (next_word ()) - 1.) * (t.fe[layer + 1] - t.fe[layer]);
+    if (y < exp (-x))
+    {
+      return (x);
+    }
+    r = next_word ();		// rejected: start over
+  }
+}
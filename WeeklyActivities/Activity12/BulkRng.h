@@ -0,0 +1,57 @@
+//  file: BulkRng.h
+//
+//  Header file for BulkRng class: uniform, gaussian and exponential
+//   random numbers generated a whole array at a time
+//
+//  Revision history:
+//      06/02/21  original version
+//      06/04/21  Ziggurat gaussian and exponential numbers
+//
+//  Notes:
+//   * gsl_ran_flat and gsl_ran_gaussian return one number per call,
+//      through a function pointer, so nothing around them vectorizes.
+//      BulkRng fills an array in one call: `lanes' interleaved
+//      xoshiro256+ generators (as in RandomWalkEnsemble), each the one
+//      before it jumped ahead by 2^128 numbers, all from a single seed.
+//   * gaussian() uses the Box-Muller transformation on pairs of uniform
+//      numbers, in blocks so the log, sin and cos are vectorized too
+//      (compile with -O3 -ffast-math to get the vector math library).
+//   * ziggurat_gaussian() and exponential() use the Ziggurat method
+//      (Marsaglia and Tsang, J. Stat. Softw. 5, 8 (2000)) with 256
+//      layers: one 64-bit random number and a table lookup give the
+//      result about 99% of the time, with no log or sqrt.  They do not
+//      depend on the vector math library, so they are the faster choice
+//      without -ffast-math.
+//   * the numbers depend only on the seed and on the sequence of calls,
+//      so a BulkRng per thread (seeded from RngStreams) is reproducible.
+//
+#ifndef BULK_RNG_H
+#define BULK_RNG_H
+
+#include <stdint.h>
+
+class BulkRng
+{
+public:
+  BulkRng (unsigned long int seed);
+
+  // u[0..n-1] uniform in [lower,upper)
+  void uniform (double *u, long n, double lower = 0., double upper = 1.);
+  // g[0..n-1] gaussian with mean zero and standard deviation sigma
+  void gaussian (double *g, long n, double sigma = 1.);	// Box-Muller
+  void ziggurat_gaussian (double *g, long n, double sigma = 1.);
+  // e[0..n-1] exponential with mean mu, p(x) = exp(-x/mu)/mu
+  void exponential (double *e, long n, double mu = 1.);
+
+  static const int lanes = 8;	// generators advanced side by side
+
+private:
+  template <class T> void fill (T *out, long n);	// bits or [1,2)
+  uint64_t next_word ();	// one more number, for the rare cases
+  double gaussian_slow (uint64_t r);	// outside the Ziggurat core
+  double exponential_slow (uint64_t r);
+
+  uint64_t s0[lanes], s1[lanes], s2[lanes], s3[lanes];	// xoshiro256+
+};
+
+#endif
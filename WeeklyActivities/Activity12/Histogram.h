@@ -0,0 +1,358 @@
+//  file: Histogram.h
+//
+//  Header file for the Histogram classes: counts of values in bins on
+//   [x_min,x_max), with the values below and above counted too.
+//   HistogramAxis finds the bin of a value (equal or variable widths),
+//   Histogram counts values x and Histogram2D pairs (x,y).
+//   HistogramShards holds one copy per OpenMP thread.  Everything is
+//   inline, so there is no Histogram.cpp.
+//
+//  Revision history:
+//      04-Jun-2021  original version
+//      05-Jun-2021  variable bins (HistogramAxis), Histogram2D,
+//                    HistogramShards, probability() and write_binary()
+//
+//  Notes:
+//   * with equal bins the bin of x is int ((x - x_min) * inv_width) with
+//      inv_width = num_bins/(x_max - x_min) worked out once, so there is
+//      no divide per value.  With variable bins (a vector of num_bins+1
+//      increasing edges) it is a binary search of the edges.
+//   * index() is 0 for the underflow and num_bins+1 for the overflow,
+//      so every value lands in some element of counts (a value outside
+//      [x_min,x_max) used to write past the end of the array).  The bin
+//      is found by comparing t = (x - x_min) * inv_width with 0 and
+//      num_bins before converting it, so a huge x cannot overflow the
+//      int; a NaN goes to the overflow.  (Not with -ffast-math, whose
+//      -ffinite-math-only lets the compiler assume there are no NaNs.)
+//   * merge() adds the counts of another histogram with the same bins.
+//      The counts are integers, so the sum does not depend on the order.
+//   * HistogramShards: each thread fills local(), its own copy, with no
+//      locks or atomics; merge_into() then adds them up on one thread,
+//      in thread order.  The copies are made for omp_get_max_threads()
+//      threads, so do not ask for more threads in the parallel region.
+//   * probability(i) is count/total and density(i) is count/(total *
+//      width), both over all values added, including those outside the
+//      range, so the densities integrate to the fraction inside.
+//   * write_binary() writes "HIST", the number of axes (int), for each
+//      axis num_bins (int) and the num_bins+1 edges (double), then all
+//      the counts (long long) including under/overflow: (num_bins+2)
+//      for a Histogram and (num_bins_x+2)*(num_bins_y+2), y fastest, for
+//      a Histogram2D.  The numbers are in the byte order of the machine.
+//
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <vector>
+#include <algorithm>		// upper_bound
+#include <fstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+class HistogramAxis
+{
+public:
+  // num_bins equal bins on [x_min,x_max)
+  HistogramAxis (int num_bins_in, double x_min_in, double x_max_in)
+  {
+    num_bins = num_bins_in;
+    x_min = x_min_in;
+    x_max = x_max_in;
+    inv_width = double (num_bins) / (x_max - x_min);
+    equal_bins = true;
+    edges.resize (num_bins + 1);
+    for (int i = 0; i <= num_bins; i++)
+    {
+      edges[i] = x_min + i / inv_width;
+    }
+    edges[num_bins] = x_max;
+  };
+  // bins [edges[i],edges[i+1]), the edges increasing
+  HistogramAxis (const std::vector<double> &edges_in)
+  {
+    edges = edges_in;
+    num_bins = int (edges.size ()) - 1;
+    x_min = edges[0];
+    x_max = edges[num_bins];
+    inv_width = double (num_bins) / (x_max - x_min);
+    equal_bins = false;
+  };
+
+  // element of counts for x: 0 below x_min, num_bins+1 at or above x_max
+  int index (double x) const
+  {
+    return (equal_bins ? equal_index (x) : search_index (x));
+  };
+  // the same for equal bins only (no test of the kind of bins)
+  int equal_index (double x) const
+  {
+    double t = (x - x_min) * inv_width;
+    if (t >= 0.)
+    {
+      return (t < num_bins ? int (t) + 1 : num_bins + 1);
+    }
+    return (t < 0. ? 0 : num_bins + 1);	// NaN fails both tests
+  };
+  // and for any bins, by binary search
+  int search_index (double x) const
+  {
+    if (x < x_min)
+    {
+      return (0);
+    }
+    if (!(x < x_max))
+    {
+      return (num_bins + 1);
+    }
+    return (int (std::upper_bound (edges.begin (), edges.end (), x)
+                 - edges.begin ()));
+  };
+
+  int get_num_bins () const { return num_bins; };
+  bool has_equal_bins () const { return equal_bins; };
+  double lower_edge (int i) const { return edges[i]; };
+  double width (int i) const { return (edges[i + 1] - edges[i]); };
+  // center of bin i
+  double x (int i) const { return (0.5 * (edges[i] + edges[i + 1])); };
+  void write_binary (std::ofstream &out) const
+  {
+    out.write ((const char *) &num_bins, sizeof (num_bins));
+    out.write ((const char *) &edges[0], (num_bins + 1) * sizeof (double));
+  };
+
+private:
+  int num_bins;
+  double x_min, x_max;
+  double inv_width;		// bins per unit of x (equal bins)
+  bool equal_bins;
+  std::vector<double> edges;	// num_bins+1 of them
+};
+
+class Histogram
+{
+public:
+  Histogram (int num_bins, double x_min, double x_max)
+    : axis (num_bins, x_min, x_max)
+  {
+    reset ();
+  };
+  Histogram (const std::vector<double> &edges) : axis (edges)
+  {
+    reset ();
+  };
+
+  void reset () { counts.assign (axis.get_num_bins () + 2, 0); };
+
+  // add one value
+  void add (double x) { counts[axis.index (x)]++; };
+  // add the values x[0..n-1]
+  void add (const double *x, long n)
+  {
+    long long *c = &counts[0];
+    if (axis.has_equal_bins ())
+    {				// the usual case, with no test per value
+      for (long i = 0; i < n; i++)
+      {
+        c[axis.equal_index (x[i])]++;
+      }
+      return;
+    }
+    for (long i = 0; i < n; i++)
+    {
+      c[axis.search_index (x[i])]++;
+    }
+  };
+
+  // add the counts of another histogram with the same bins
+  void merge (const Histogram &other)
+  {
+    for (size_t k = 0; k < counts.size (); k++)
+    {
+      counts[k] += other.counts[k];
+    }
+  };
+
+  int get_num_bins () const { return axis.get_num_bins (); };
+  const HistogramAxis &get_axis () const { return axis; };
+  // count in bin i = 0..num_bins-1
+  long long count (int i) const { return counts[i + 1]; };
+  long long underflow () const { return counts[0]; };
+  long long overflow () const { return counts[axis.get_num_bins () + 1]; };
+  // all values added, in range or not
+  long long total () const
+  {
+    long long sum = 0;
+    for (size_t k = 0; k < counts.size (); k++)
+    {
+      sum += counts[k];
+    }
+    return (sum);
+  };
+  // center and width of bin i
+  double x (int i) const { return axis.x (i); };
+  double width (int i) const { return axis.width (i); };
+  // fraction of the values in bin i
+  double probability (int i) const
+  {
+    long long n = total ();
+    return (n > 0 ? double (count (i)) / double (n) : 0.);
+  };
+  // estimate of the probability density at x(i)
+  double density (int i) const { return (probability (i) / width (i)); };
+
+  // the bins and counts in binary (see the notes); false on an error
+  bool write_binary (const char *filename) const
+  {
+    std::ofstream out (filename, std::ios::out | std::ios::binary);
+    int num_axes = 1;
+    out.write ("HIST", 4);
+    out.write ((const char *) &num_axes, sizeof (num_axes));
+    axis.write_binary (out);
+    out.write ((const char *) &counts[0], counts.size () * sizeof (long long));
+    return (bool (out));
+  };
+
+private:
+  HistogramAxis axis;
+  std::vector<long long> counts;	// underflow, bins, overflow
+};
+
+class Histogram2D
+{
+public:
+  Histogram2D (const HistogramAxis &x_axis_in,
+               const HistogramAxis &y_axis_in)
+    : x_axis (x_axis_in), y_axis (y_axis_in)
+  {
+    reset ();
+  };
+
+  void reset ()
+  {
+    stride = y_axis.get_num_bins () + 2;
+    counts.assign ((x_axis.get_num_bins () + 2) * stride, 0);
+  };
+
+  // add one pair (x,y)
+  void add (double x, double y)
+  {
+    counts[x_axis.index (x) * stride + y_axis.index (y)]++;
+  };
+  // add the pairs (x[0],y[0]), ..., (x[n-1],y[n-1])
+  void add (const double *x, const double *y, long n)
+  {
+    long long *c = &counts[0];
+    if (x_axis.has_equal_bins () && y_axis.has_equal_bins ())
+    {
+      for (long i = 0; i < n; i++)
+      {
+        c[x_axis.equal_index (x[i]) * stride + y_axis.equal_index (y[i])]++;
+      }
+      return;
+    }
+    for (long i = 0; i < n; i++)
+    {
+      c[x_axis.index (x[i]) * stride + y_axis.index (y[i])]++;
+    }
+  };
+
+  // add the counts of another histogram with the same bins
+  void merge (const Histogram2D &other)
+  {
+    for (size_t k = 0; k < counts.size (); k++)
+    {
+      counts[k] += other.counts[k];
+    }
+  };
+
+  const HistogramAxis &get_x_axis () const { return x_axis; };
+  const HistogramAxis &get_y_axis () const { return y_axis; };
+  // count in bin (i,j); i or j = -1 or num_bins for under/overflow
+  long long count (int i, int j) const
+  {
+    return counts[(i + 1) * stride + j + 1];
+  };
+  // all pairs added, in range or not
+  long long total () const
+  {
+    long long sum = 0;
+    for (size_t k = 0; k < counts.size (); k++)
+    {
+      sum += counts[k];
+    }
+    return (sum);
+  };
+  double probability (int i, int j) const
+  {
+    long long n = total ();
+    return (n > 0 ? double (count (i, j)) / double (n) : 0.);
+  };
+  double density (int i, int j) const
+  {
+    return (probability (i, j) / (x_axis.width (i) * y_axis.width (j)));
+  };
+
+  // the bins and counts in binary (see the notes); false on an error
+  bool write_binary (const char *filename) const
+  {
+    std::ofstream out (filename, std::ios::out | std::ios::binary);
+    int num_axes = 2;
+    out.write ("HIST", 4);
+    out.write ((const char *) &num_axes, sizeof (num_axes));
+    x_axis.write_binary (out);
+    y_axis.write_binary (out);
+    out.write ((const char *) &counts[0], counts.size () * sizeof (long long));
+    return (bool (out));
+  };
+
+private:
+  HistogramAxis x_axis, y_axis;
+  int stride;			// elements of counts per x bin
+  std::vector<long long> counts;	// x index * stride + y index
+};
+
+// One copy of a histogram (Histogram or Histogram2D) per OpenMP thread.
+//  Make it before the parallel region, fill local() inside it, and
+//  merge_into() after it.
+template <class H>
+class HistogramShards
+{
+public:
+  HistogramShards (const H &h)
+  {
+    int num_threads = 1;
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads ();
+#endif
+    for (int t = 0; t < num_threads; t++)
+    {
+      shards.push_back (h);
+      shards[t].reset ();
+    }
+  };
+
+  // the copy of the calling thread
+  H &local ()
+  {
+#ifdef _OPENMP
+    return shards[omp_get_thread_num ()];
+#else
+    return shards[0];
+#endif
+  };
+
+  // add all the copies to h, in thread order
+  void merge_into (H &h) const
+  {
+    for (size_t t = 0; t < shards.size (); t++)
+    {
+      h.merge (shards[t]);
+    }
+  };
+
+private:
+  std::vector<H> shards;
+};
+
+#endif
@@ -0,0 +1,227 @@
+//  file: MCAccumulator.h
+//
+//  Header file for the MCAccumulator class: running statistics of a
+//   Monte Carlo observable (one value per measurement) with error bars
+//   that account for the correlations between successive measurements.
+//   Everything is inline, so there is no MCAccumulator.cpp.
+//
+//  Revision history:
+//      27-May-2021  original version
+//      07-Jun-2021  add_independent() for a block of independent values
+//
+//  Notes:
+//   * mean and variance are updated with Welford's algorithm, which does
+//      not lose precision the way sum_E2/n - (sum_E/n)^2 can.
+//   * blocking (binning): level k holds the statistics of the averages
+//      of 2^k consecutive values, built on the fly by averaging pairs, so
+//      only one pending value per level is stored.  The naive error
+//      sqrt(variance/n) is too small for correlated values; the error
+//      from the bins grows with k and levels off once the bins are longer
+//      than the correlation time.  error() is taken from the first level
+//      with bins of B values where B^3 > 2 n (error_B/naive error)^4 (Lee
+//      et al., PRE 83, 066706), or the deepest with min_bins bins.
+//   * tau_int = (1/2) (error / naive error)^2, in units of the spacing
+//      of the measurements (1/2 for uncorrelated values).
+//   * merge() adds the statistics of another accumulator, e.g. one per
+//      OpenMP thread, each filled without locks and merged at the end.
+//      The bins of the two are combined as if they came from independent
+//      chains, which is what the threads are.
+//   * add_independent(x, n) is for values known to be independent, such
+//      as the integrand at Monte Carlo points: the mean and the sum of
+//      squared deviations of the n values are found in two vectorizable
+//      passes and combined with level 0 as in merge(), with no bins.
+//      error() is then naive_error(), which is right for such values,
+//      and it costs about 1 ns per value instead of about 7 for add().
+//      Do not mix it with add() in the same accumulator.
+//
+#ifndef MC_ACCUMULATOR_H
+#define MC_ACCUMULATOR_H
+
+#include <cmath>
+
+class MCAccumulator
+{
+public:
+  MCAccumulator (int min_bins_in = 32)
+  {
+    min_bins = min_bins_in;
+    reset ();
+  };
+
+  void reset ()
+  {
+    for (int k = 0; k < max_levels; k++)
+    {
+      num[k] = 0;
+      avg[k] = 0.;
+      m2[k] = 0.;
+      has_pending[k] = false;
+      pending[k] = 0.;
+    }
+  };
+
+  // add one measurement
+  void add (double x)
+  {
+    record (0, x);
+    carry (0, x);
+  };
+
+  // add the n independent measurements x[0..n-1], without bins
+  void add_independent (const double *x, long n)
+  {
+    if (n <= 0)
+    {
+      return;
+    }
+    double sum = 0.;
+    for (long i = 0; i < n; i++)
+    {
+      sum += x[i];
+    }
+    double x_avg = sum / double (n);
+    double x_m2 = 0.;
+    for (long i = 0; i < n; i++)
+    {
+      x_m2 += (x[i] - x_avg) * (x[i] - x_avg);
+    }
+    combine (0, n, x_avg, x_m2);
+  };
+
+  // add the statistics of another accumulator (same min_bins)
+  void merge (const MCAccumulator &other)
+  {
+    for (int k = 0; k < max_levels; k++)
+    {
+      if (other.num[k] > 0)
+      {
+        combine (k, other.num[k], other.avg[k], other.m2[k]);
+      }
+    }
+    // the leftover values of other pair up with ours, bottom level first
+    for (int k = 0; k < max_levels; k++)
+    {
+      if (other.has_pending[k])
+      {
+        carry (k, other.pending[k]);
+      }
+    }
+  };
+
+  long long count () const { return num[0]; };
+  double mean () const { return avg[0]; };
+  // sample variance of the measurements (0 for fewer than two)
+  double variance () const { return level_variance (0); };
+  // error of the mean if the measurements were independent
+  double naive_error () const { return level_error (0); };
+
+  // error of the mean from the bins of 2^level values
+  double level_error (int level) const
+  {
+    if (num[level] < 2)
+    {
+      return (0.);
+    }
+    return (sqrt (level_variance (level) / double (num[level])));
+  };
+  long long num_bins (int level) const { return num[level]; };
+  int get_num_levels () const
+  {
+    int k = 0;
+    while (k < max_levels && num[k] > 0)
+    {
+      k++;
+    }
+    return (k);
+  };
+
+  // error of the mean with the correlations included
+  double error () const { return level_error (error_level ()); };
+  // integrated autocorrelation time in units of the measurement spacing
+  double tau_int () const
+  {
+    double naive = naive_error ();
+    if (naive == 0.)
+    {
+      return (0.5);
+    }
+    double ratio = error () / naive;
+    return (0.5 * ratio * ratio);
+  };
+  // the smallest level whose bins of B = 2^level values are long enough,
+  //  B^3 > 2 n (level_error/naive_error)^4, and which has min_bins bins
+  int error_level () const
+  {
+    double naive = naive_error ();
+    if (naive == 0.)
+    {
+      return (0);
+    }
+    double n = double (num[0]);
+    int k = 0;
+    for (int level = 1; level < max_levels && num[level] >= min_bins;
+         level++)
+    {
+      double B = ldexp (1., level);	// 2^level
+      double ratio = level_error (level) / naive;
+      k = level;
+      if (B * B * B > 2. * n * ratio * ratio * ratio * ratio)
+      {
+        break;
+      }
+    }
+    return (k);
+  };
+
+private:
+  static const int max_levels = 48;	// bins of up to 2^47 values
+
+  // Welford update of level k with one more value
+  void record (int k, double x)
+  {
+    num[k]++;
+    double delta = x - avg[k];
+    avg[k] += delta / double (num[k]);
+    m2[k] += delta * (x - avg[k]);
+  };
+  // add n_b values with mean avg_b and m2_b to level k (Chan et al.)
+  void combine (int k, long long n_b, double avg_b, double m2_b)
+  {
+    double n_a = double (num[k]);
+    double delta = avg_b - avg[k];
+    num[k] += n_b;
+    avg[k] += delta * double (n_b) / (n_a + double (n_b));
+    m2[k] += m2_b + delta * delta * n_a * double (n_b) / (n_a + double (n_b));
+  };
+  // x is a finished bin at level k: pair it with the pending one and
+  //  record the average one level up, and so on
+  void carry (int k, double x)
+  {
+    while (k + 1 < max_levels)
+    {
+      if (!has_pending[k])
+      {
+        pending[k] = x;
+        has_pending[k] = true;
+        return;
+      }
+      x = 0.5 * (pending[k] + x);
+      has_pending[k] = false;
+      k++;
+      record (k, x);
+    }
+  };
+  double level_variance (int k) const
+  {
+    return (num[k] < 2 ? 0. : m2[k] / double (num[k] - 1));
+  };
+
+  int min_bins;			// bins needed to trust a level
+  long long num[max_levels];	// number of bins at each level
+  double avg[max_levels];	// their mean
+  double m2[max_levels];	// sum of squared deviations from the mean
+  bool has_pending[max_levels];	// a bin waiting for its partner
+  double pending[max_levels];
+};
+
+#endif
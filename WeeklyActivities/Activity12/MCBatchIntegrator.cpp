@@ -0,0 +1,72 @@
+//  file: MCBatchIntegrator.cpp
+//
+//  Member functions for MCBatchIntegrator class
+//
+//  Revision history:
+//      06/02/21  original version
+//      06/07/21  values added a block at a time (add_independent)
+//
+//  Notes:
+//   * for a block of n < block_size points (the last one) the
+//      coordinates are packed as x[k*n + i], as func.f expects.
+//   * the points are independent, so the values of a block go into the
+//      MCAccumulator with add_independent(), without the blocking
+//      levels that add() keeps up for each value.
+//
+//******************************************************************
+
+// include files
+#include "MCBatchIntegrator.h"
+
+//********************************************************************
+// Constructor for MCBatchIntegrator
+MCBatchIntegrator::MCBatchIntegrator (size_t dim_in, unsigned long int seed,
+                                      size_t block_size_in)
+  : rng (seed)
+{
+  dim = dim_in;
+  block_size = block_size_in;
+  x.resize (dim * block_size);
+  values.resize (block_size);
+}
+
+//********************************************************************
+// Points uniform in the box [lower,upper]^dim
+void
+MCBatchIntegrator::sample_uniform (const mc_batch_function &func,
+                                   double lower, double upper,
+                                   long num_points, MCAccumulator &acc)
+{
+  for (long done = 0; done < num_points; done += block_size)
+  {
+    size_t n = (num_points - done < long (block_size) ?
+                size_t (num_points - done) : block_size);
+    rng.uniform (&x[0], long (dim * n), lower, upper);
+    evaluate (func, n, acc);
+  }
+}
+
+// Points gaussian with mean 0 and standard deviation sigma in each
+//  coordinate
+void
+MCBatchIntegrator::sample_gaussian (const mc_batch_function &func,
+                                    double sigma, long num_points,
+                                    MCAccumulator &acc)
+{
+  for (long done = 0; done < num_points; done += block_size)
+  {
+    size_t n = (num_points - done < long (block_size) ?
+                size_t (num_points - done) : block_size);
+    rng.gaussian (&x[0], long (dim * n), sigma);
+    evaluate (func, n, acc);
+  }
+}
+
+// Values of the integrand at the n points in x, added to acc
+void
+MCBatchIntegrator::evaluate (const mc_batch_function &func, size_t n,
+                             MCAccumulator &acc)
+{
+  func.f (&x[0], dim, n, func.params, &values[0]);
+  acc.add_independent (&values[0], long (n));
+}
@@ -0,0 +1,70 @@
+//  file: MCBatchIntegrator.h
+//
+//  Header file for MCBatchIntegrator class: Monte Carlo sampling of an
+//   integrand that is evaluated a block of points at a time
+//
+//  Revision history:
+//      06/02/21  original version
+//      06/07/21  values added with MCAccumulator::add_independent()
+//
+//  Notes:
+//   * an mc_batch_function is like a gsl_monte_function, but f gets n
+//      points at once in "structure of arrays" form, x[k*n + i] being
+//      coordinate k of point i, and fills values[0..n-1].  The loops
+//      over the points are then simple loops over arrays that the
+//      compiler can vectorize, and the constant factors of the integrand
+//      are computed once per block instead of once per point.
+//   * the points are made a block at a time by a BulkRng, uniformly in
+//      the box [lower,upper]^dim or gaussian with standard deviation
+//      sigma in each coordinate, and the values are added to an
+//      MCAccumulator with add_independent(), so its error() is the
+//      naive error (and acc should not also get values from add()).
+//      The volume (or the weight function) is left to the caller, as
+//      in mc_integration.cpp.
+//
+#ifndef MC_BATCH_INTEGRATOR_H
+#define MC_BATCH_INTEGRATOR_H
+
+#include <vector>
+#include <cstddef>
+
+#include "BulkRng.h"
+#include "MCAccumulator.h"
+
+// integrand evaluated at n points x[k*n + i], i < n, k < dim
+struct mc_batch_function
+{
+  void (*f) (const double *x, size_t dim, size_t n, void *params,
+             double *values);
+  size_t dim;
+  void *params;
+};
+
+class MCBatchIntegrator
+{
+public:
+  MCBatchIntegrator (size_t dim, unsigned long int seed,
+                     size_t block_size = 1024);
+
+  // add num_points values of f to acc, at points uniform in
+  //  [lower,upper]^dim or gaussian with standard deviation sigma
+  void sample_uniform (const mc_batch_function &func, double lower,
+                       double upper, long num_points, MCAccumulator &acc);
+  void sample_gaussian (const mc_batch_function &func, double sigma,
+                        long num_points, MCAccumulator &acc);
+
+  size_t get_dim () { return dim; };
+  size_t get_block_size () { return block_size; };
+
+private:
+  void evaluate (const mc_batch_function &func, size_t n,
+                 MCAccumulator &acc);
+
+  size_t dim;
+  size_t block_size;		// points per call of func.f
+  BulkRng rng;
+  std::vector<double> x;	// dim * block_size coordinates
+  std::vector<double> values;	// block_size values of the integrand
+};
+
+#endif
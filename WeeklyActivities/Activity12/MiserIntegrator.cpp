@@ -0,0 +1,264 @@
+//  file: MiserIntegrator.cpp
+//
+//  Member functions for MiserIntegrator class
+//
+//  Revision history:
+//      06/03/21  original version
+//
+//  Notes:
+//   * the variance estimate of a region follows estimate_corrmc in
+//      GSL's monte/miser.c: point n of the estimate is in the upper half
+//      (n even) or lower half (n odd) of coordinate (n/2) % dim and
+//      uniform in the rest, so every half gets some points.  As in GSL
+//      the estimate points are not part of the result.
+//   * the halves of a region with at least task_calls calls are OpenMP
+//      tasks; the results are added left + right in the same order
+//      whichever thread finishes first.
+//
+//******************************************************************
+
+// include files
+#include <cmath>
+#include <cfloat>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "MiserIntegrator.h"
+#include "BulkRng.h"
+
+// SplitMix64 finalizer, to make the seeds of the subregions
+static inline unsigned long long
+mix64 (unsigned long long z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return (z ^ (z >> 31));
+}
+
+//********************************************************************
+// Constructor for MiserIntegrator, with the GSL defaults
+MiserIntegrator::MiserIntegrator (size_t dim_in, unsigned long int seed_in)
+{
+  dim = dim_in;
+  seed = seed_in;
+  threads = 0;
+  call_count = 0;
+
+  estimate_frac = 0.1;
+  min_calls = 16 * dim;
+  min_calls_per_bisection = 32 * min_calls;
+  alpha = 2.;
+  dither = 0.;
+}
+
+//********************************************************************
+void
+MiserIntegrator::integrate (const mc_batch_function &func,
+                            const double xl[], const double xu[],
+                            size_t calls, double *result, double *abserr)
+{
+  unsigned long long root_seed =
+    mix64 (mix64 (seed) + (call_count + 1) * 0x9e3779b97f4a7c15ULL);
+  call_count++;
+#ifdef _OPENMP
+  int num_threads = (threads > 0 ? threads : omp_get_max_threads ());
+#pragma omp parallel num_threads(num_threads)
+#pragma omp single
+#endif
+  miser (func, xl, xu, calls, root_seed, result, abserr);
+}
+
+// Plain Monte Carlo: calls points uniform in the region
+void
+MiserIntegrator::plain (const mc_batch_function &func, const double xl[],
+                        const double xu[], size_t calls, BulkRng &rng,
+                        double *result, double *abserr)
+{
+  std::vector<double> x (dim * block_size);
+  std::vector<double> values (block_size);
+  double vol = 1.;
+  for (size_t i = 0; i < dim; i++)
+  {
+    vol *= xu[i] - xl[i];
+  }
+
+  double m = 0.;
+  double q = 0.;
+  for (size_t done = 0; done < calls; done += block_size)
+  {
+    size_t n = (calls - done < block_size ? calls - done : block_size);
+    for (size_t i = 0; i < dim; i++)
+    {
+      rng.uniform (&x[i * n], long (n), xl[i], xu[i]);
+    }
+    func.f (&x[0], dim, n, func.params, &values[0]);
+    for (size_t p = 0; p < n; p++)
+    {
+      double k = double (done + p);
+      double delta = values[p] - m;	// mean and variance as in GSL
+      m += delta / (k + 1.);
+      q += delta * delta * (k / (k + 1.));
+    }
+  }
+  *result = vol * m;
+  *abserr = (calls < 2 ? HUGE_VAL : vol * sqrt (q / (calls * (calls - 1.))));
+}
+
+//********************************************************************
+// Recursive bisection of the region xl..xu with calls points
+void
+MiserIntegrator::miser (const mc_batch_function &func, const double xl[],
+                        const double xu[], size_t calls,
+                        unsigned long long region_seed, double *result,
+                        double *abserr)
+{
+  BulkRng rng ((unsigned long int) region_seed);
+  if (calls < min_calls_per_bisection)
+  {
+    plain (func, xl, xu, calls, rng, result, abserr);
+    return;
+  }
+
+  double vol = 1.;
+  for (size_t i = 0; i < dim; i++)
+  {
+    vol *= xu[i] - xl[i];
+  }
+
+  // midpoints, with some fuzz if dither > 0
+  std::vector<double> xmid (dim);
+  std::vector<double> coin (dim);
+  rng.uniform (&coin[0], long (dim));
+  for (size_t i = 0; i < dim; i++)
+  {
+    double s = (coin[i] - 0.5 >= 0. ? dither : -dither);
+    xmid[i] = (0.5 + s) * xl[i] + (0.5 - s) * xu[i];
+  }
+
+  // estimate the variance on either side of each midpoint
+  size_t estimate_calls = size_t (calls * estimate_frac);
+  estimate_calls = (estimate_calls > min_calls ? estimate_calls : min_calls);
+  std::vector<double> fsum_l (dim, 0.), fsum_r (dim, 0.);
+  std::vector<double> fsum2_l (dim, 0.), fsum2_r (dim, 0.);
+  std::vector<double> hits_l (dim, 0.), hits_r (dim, 0.);
+  std::vector<double> x (dim * block_size);
+  std::vector<double> values (block_size);
+  for (size_t done = 0; done < estimate_calls; done += block_size)
+  {
+    size_t n = (estimate_calls - done < block_size ? estimate_calls - done
+                : block_size);
+    rng.uniform (&x[0], long (dim * n));
+    for (size_t i = 0; i < dim; i++)
+    {
+      double *x_i = &x[i * n];
+      for (size_t p = 0; p < n; p++)
+      {
+        size_t k = done + p;
+        double lower = xl[i];
+        double upper = xu[i];
+        if ((k / 2) % dim == i)
+        {
+          if (k % 2 == 0)
+          {
+            lower = xmid[i];
+          }
+          else
+          {
+            upper = xmid[i];
+          }
+        }
+        x_i[p] = lower + x_i[p] * (upper - lower);
+      }
+    }
+    func.f (&x[0], dim, n, func.params, &values[0]);
+    for (size_t i = 0; i < dim; i++)
+    {
+      const double *x_i = &x[i * n];
+      for (size_t p = 0; p < n; p++)
+      {
+        double fval = values[p];
+        if (x_i[p] <= xmid[i])
+        {
+          fsum_l[i] += fval;
+          fsum2_l[i] += fval * fval;
+          hits_l[i]++;
+        }
+        else
+        {
+          fsum_r[i] += fval;
+          fsum2_r[i] += fval * fval;
+          hits_r[i]++;
+        }
+      }
+    }
+  }
+  calls -= estimate_calls;
+
+  // choose the coordinate whose bisection gives the smallest variance
+  double beta = 2. / (1. + alpha);
+  double best_var = DBL_MAX;
+  double weight_l = 1.;
+  double weight_r = 1.;
+  int i_bisect = -1;
+  for (size_t i = 0; i < dim; i++)
+  {
+    if (hits_l[i] < 2 || hits_r[i] < 2)
+    {
+      continue;
+    }
+    double fraction_l = (xmid[i] - xl[i]) / (xu[i] - xl[i]);
+    double mean_l = fsum_l[i] / hits_l[i];
+    double mean_r = fsum_r[i] / hits_r[i];
+    double var_l = fsum2_l[i] / hits_l[i] - mean_l * mean_l;
+    double var_r = fsum2_r[i] / hits_r[i] - mean_r * mean_r;
+    double sigma_l = fraction_l * vol * sqrt (var_l > 0. ? var_l : 0.);
+    double sigma_r = (1. - fraction_l) * vol * sqrt (var_r > 0. ? var_r : 0.);
+    double var = pow (sigma_l, beta) + pow (sigma_r, beta);
+    if (var <= best_var)
+    {
+      best_var = var;
+      i_bisect = int (i);
+      weight_l = pow (sigma_l, beta);
+      weight_r = pow (sigma_r, beta);
+      if (weight_l == 0. && weight_r == 0.)
+      {
+        weight_l = weight_r = 1.;
+      }
+    }
+  }
+  if (i_bisect < 0)
+  {				// no estimate: pick a coordinate at random
+    double u;
+    rng.uniform (&u, 1);
+    i_bisect = int (u * dim);
+  }
+
+  // share the remaining calls between the halves
+  double fraction_l = fabs ((xmid[i_bisect] - xl[i_bisect])
+                            / (xu[i_bisect] - xl[i_bisect]));
+  double a = fraction_l * weight_l;
+  double b = (1. - fraction_l) * weight_r;
+  size_t calls_l = min_calls + size_t ((calls - 2 * min_calls) * a / (a + b));
+  size_t calls_r = min_calls + size_t ((calls - 2 * min_calls) * b / (a + b));
+
+  std::vector<double> xu_l (xu, xu + dim);
+  std::vector<double> xl_r (xl, xl + dim);
+  xu_l[i_bisect] = xmid[i_bisect];
+  xl_r[i_bisect] = xmid[i_bisect];
+  double res_l, err_l, res_r, err_r;
+  unsigned long long seed_l = mix64 (region_seed + 0x9e3779b97f4a7c15ULL);
+  unsigned long long seed_r = mix64 (region_seed + 2 * 0x9e3779b97f4a7c15ULL);
+#ifdef _OPENMP
+#pragma omp task shared(func, xu_l, res_l, err_l) if(calls_l >= task_calls)
+#endif
+  miser (func, xl, &xu_l[0], calls_l, seed_l, &res_l, &err_l);
+  miser (func, &xl_r[0], xu, calls_r, seed_r, &res_r, &err_r);
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
+
+  *result = res_l + res_r;
+  *abserr = sqrt (err_l * err_l + err_r * err_r);
+}
@@ -0,0 +1,77 @@
+//  file: MiserIntegrator.h
+//
+//  Header file for MiserIntegrator class: Monte Carlo integration with
+//   recursive stratified sampling by the MISER algorithm (Press and
+//   Farrar), with the subregions spread over OpenMP threads
+//
+//  Revision history:
+//      06/03/21  original version
+//
+//  Notes:
+//   * the algorithm and its parameters are those of gsl_monte_miser: a
+//      fraction estimate_frac of the calls of a region goes into
+//      estimating the variance of f on either side of the midpoint of
+//      each coordinate; the region is split along the coordinate that
+//      gives the smallest sigma_l^b + sigma_r^b (b = 2/(1+alpha)) and the
+//      rest of the calls are shared in proportion to fraction * sigma^b.
+//      A region with fewer than min_calls_per_bisection calls is sampled
+//      uniformly (plain Monte Carlo).
+//   * the integrand is an mc_batch_function, evaluated a block of points
+//      at a time.
+//   * every region has its own BulkRng, seeded from the seed of its
+//      parent region and which half it is, so the two halves can be done
+//      as OpenMP tasks and the result depends only on the seed, not on
+//      the number of threads.
+//
+#ifndef MISER_INTEGRATOR_H
+#define MISER_INTEGRATOR_H
+
+#include <vector>
+#include <cstddef>
+
+#include "MCBatchIntegrator.h"	// mc_batch_function
+
+class MiserIntegrator
+{
+public:
+  MiserIntegrator (size_t dim, unsigned long int seed);
+
+  // integral of func over the box xl[k] < x[k] < xu[k]
+  void integrate (const mc_batch_function &func, const double xl[],
+                  const double xu[], size_t calls, double *result,
+                  double *abserr);
+
+  void set_estimate_frac (double frac) { estimate_frac = frac; };
+  void set_min_calls (size_t num) { min_calls = num; };
+  void set_min_calls_per_bisection (size_t num)
+  {
+    min_calls_per_bisection = num;
+  };
+  void set_alpha (double alpha_in) { alpha = alpha_in; };
+  void set_dither (double dither_in) { dither = dither_in; };
+  void set_threads (int num_threads) { threads = num_threads; };	// 0 = all
+
+  static const size_t block_size = 1024;	// points per call of func.f
+  static const size_t task_calls = 20000;	// smallest region for a task
+
+private:
+  void miser (const mc_batch_function &func, const double xl[],
+              const double xu[], size_t calls, unsigned long long region_seed,
+              double *result, double *abserr);
+  void plain (const mc_batch_function &func, const double xl[],
+              const double xu[], size_t calls, BulkRng &rng,
+              double *result, double *abserr);
+
+  size_t dim;
+  unsigned long int seed;
+  int threads;
+  long call_count;		// calls of integrate() so far (for the seeds)
+
+  double estimate_frac;
+  size_t min_calls;
+  size_t min_calls_per_bisection;
+  double alpha;
+  double dither;
+};
+
+#endif
@@ -0,0 +1,408 @@
+//  file: LatticeWalk.cpp
+//
+//  Member functions for LatticeWalk class that generates random walks
+//   and self-avoiding walks on a hypercubic lattice
+//
+//  Revision history:
+//      05/31/21  original version
+//
+//  Notes:
+//   * a step is one of the 2*dim unit vectors; direction k moves along
+//      axis k/2, forward for even k and backward for odd k.  Since each
+//      coordinate has its own bit field in a key, the key of a neighbor
+//      is the key of the site plus or minus 2^(axis*coord_bits).
+//   * sites are found with Fibonacci hashing (multiply by 2^64/golden
+//      ratio, keep the top bits) and linear probing; there are at least
+//      twice as many slots as sites.  erase_site() shifts later entries
+//      of a probe run back, so no tombstones are needed.
+//   * perm() is the depth-first version of PERM: the walk grows one step
+//      at a time, each level remembers how many copies of it are left to
+//      grow, and a finished or dead branch is undone site by site.  With
+//      c_minus = 0 and c_plus = infinity it is the Rosenbluth method.
+//   * uses the GSL random number functions (gsl_rng_taus)
+//
+//******************************************************************
+
+// include files
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+using namespace std;
+
+#include "LatticeWalk.h"
+
+// ln(exp(a) + exp(b)) without overflow; either may be -infinity
+static inline double
+log_add (double a, double b)
+{
+  if (a < b)
+  {
+    double tmp = a;
+    a = b;
+    b = tmp;
+  }
+  if (b == -HUGE_VAL)
+  {
+    return (a);
+  }
+  return (a + log1p (exp (b - a)));
+}
+
+//********************************************************************
+// Constructor for LatticeWalk
+LatticeWalk::LatticeWalk (int dim_in, int max_steps_in,
+                          unsigned long int seed)
+{
+  dim = dim_in;
+  max_steps = max_steps_in;
+  if (dim < 1 || dim > 16)
+  {
+    cerr << "LatticeWalk: dim = " << dim << " must be 1 to 16" << endl;
+    exit (1);
+  }
+  coord_bits = 64 / dim;
+  if (coord_bits < 32 && max_steps >= (1L << (coord_bits - 1)))
+  {
+    cerr << "LatticeWalk: max_steps = " << max_steps << " is too long for "
+         << dim << " dimensions (at most " << (1L << (coord_bits - 1)) - 1
+         << ")" << endl;
+    exit (1);
+  }
+
+  // hash set with at least twice as many slots as sites in a walk
+  int log2_slots = 4;
+  while ((1L << log2_slots) < 2L * (max_steps + 1))
+  {
+    log2_slots++;
+  }
+  keys.assign (1L << log2_slots, 0);
+  stamp.assign (1L << log2_slots, 0);
+  current = 1;
+  mask = (uint64_t (1) << log2_slots) - 1;
+  hash_shift = 64 - log2_slots;
+
+  path.assign ((size_t) (max_steps + 1) * dim, 0);
+  path_keys.assign (max_steps + 1, 0);
+  copies_left.assign (max_steps + 1, 0);
+  level_ln_weight.assign (max_steps + 1, 0.);
+  ln_m.assign (2 * dim + 1, -HUGE_VAL);
+  for (int m = 1; m <= 2 * dim; m++)
+  {
+    ln_m[m] = log (double (m));
+  }
+  clear_statistics ();
+
+  rng_ptr = gsl_rng_alloc (gsl_rng_taus);	// allocate the rng
+  gsl_rng_set (rng_ptr, seed);	// seed the rng
+}
+
+// Destructor for LatticeWalk
+LatticeWalk::~LatticeWalk ()
+{
+  gsl_rng_free (rng_ptr);	// free the random number generator
+}
+
+//********************************************************************
+// The hash set of occupied sites
+
+uint64_t
+LatticeWalk::site_key (const int *site)
+{
+  const uint64_t offset = uint64_t (1) << (coord_bits - 1);
+  uint64_t key = 0;
+  for (int a = 0; a < dim; a++)
+  {
+    key += (uint64_t (int64_t (site[a])) + offset) << (a * coord_bits);
+  }
+  return (key);
+}
+
+// Empty the set in O(1) by starting a new stamp
+void
+LatticeWalk::clear_sites ()
+{
+  current++;
+  if (current == 0)		// wrapped around: really clear, once
+  {
+    stamp.assign (stamp.size (), 0);
+    current = 1;
+  }
+}
+
+bool
+LatticeWalk::insert_site (uint64_t key)
+{
+  uint64_t i = (key * 0x9e3779b97f4a7c15ULL) >> hash_shift;
+  while (stamp[i] == current)
+  {
+    if (keys[i] == key)
+    {
+      return (false);
+    }
+    i = (i + 1) & mask;
+  }
+  keys[i] = key;
+  stamp[i] = current;
+  return (true);
+}
+
+bool
+LatticeWalk::occupied (uint64_t key)
+{
+  uint64_t i = (key * 0x9e3779b97f4a7c15ULL) >> hash_shift;
+  while (stamp[i] == current)
+  {
+    if (keys[i] == key)
+    {
+      return (true);
+    }
+    i = (i + 1) & mask;
+  }
+  return (false);
+}
+
+// Remove key (which must be in the set), moving back any later entry of
+//  the probe run whose home slot is at or before the hole
+void
+LatticeWalk::erase_site (uint64_t key)
+{
+  uint64_t i = (key * 0x9e3779b97f4a7c15ULL) >> hash_shift;
+  while (keys[i] != key || stamp[i] != current)
+  {
+    i = (i + 1) & mask;
+  }
+  uint64_t j = i;
+  while (true)
+  {
+    j = (j + 1) & mask;
+    if (stamp[j] != current)
+    {
+      break;
+    }
+    uint64_t home = (keys[j] * 0x9e3779b97f4a7c15ULL) >> hash_shift;
+    // can the entry at j move to i?  Only if home is not in (i, j]
+    if (((j - home) & mask) >= ((j - i) & mask))
+    {
+      keys[i] = keys[j];
+      i = j;
+    }
+  }
+  stamp[i] = 0;
+}
+
+//********************************************************************
+// Ordinary lattice walk (sites may be visited more than once)
+long
+LatticeWalk::random_walk (int num_steps)
+{
+  int *site = &path[0];
+  for (int a = 0; a < dim; a++)
+  {
+    site[a] = 0;
+  }
+  for (int n = 0; n < num_steps; n++)
+  {
+    int k = int (gsl_rng_uniform_int (rng_ptr, 2 * dim));
+    site[k / 2] += (k % 2 == 0 ? 1 : -1);
+  }
+  long R2 = 0;
+  for (int a = 0; a < dim; a++)
+  {
+    R2 += long (site[a]) * site[a];
+  }
+  return (R2);
+}
+
+// Simple sampling of a self-avoiding walk: a random walk that is
+//  rejected (returns -1) as soon as it steps on an occupied site
+long
+LatticeWalk::self_avoiding_walk (int num_steps)
+{
+  if (num_steps > max_steps)
+  {
+    cerr << "LatticeWalk: " << num_steps << " steps > max_steps" << endl;
+    exit (1);
+  }
+  int *site = &path[0];
+  for (int a = 0; a < dim; a++)
+  {
+    site[a] = 0;
+  }
+  clear_sites ();
+  uint64_t key = site_key (site);
+  insert_site (key);
+  for (int n = 0; n < num_steps; n++)
+  {
+    int k = int (gsl_rng_uniform_int (rng_ptr, 2 * dim));
+    uint64_t unit = uint64_t (1) << ((k / 2) * coord_bits);
+    key = (k % 2 == 0 ? key + unit : key - unit);
+    if (!insert_site (key))
+    {
+      return (-1);
+    }
+    site[k / 2] += (k % 2 == 0 ? 1 : -1);
+  }
+  long R2 = 0;
+  for (int a = 0; a < dim; a++)
+  {
+    R2 += long (site[a]) * site[a];
+  }
+  return (R2);
+}
+
+//********************************************************************
+// Rosenbluth and PERM
+
+void
+LatticeWalk::clear_statistics ()
+{
+  ln_weight_sum.assign (max_steps + 1, -HUGE_VAL);
+  ln_R2_sum.assign (max_steps + 1, -HUGE_VAL);
+  num_samples.assign (max_steps + 1, 0);
+  num_tours_total = 0;
+}
+
+// Add the walk path[0..n], with weight exp(ln_weight), to the sums
+void
+LatticeWalk::record (int n, double ln_weight)
+{
+  const int *site = &path[(size_t) n * dim];
+  long R2 = 0;
+  for (int a = 0; a < dim; a++)
+  {
+    R2 += long (site[a]) * site[a];
+  }
+  ln_weight_sum[n] = log_add (ln_weight_sum[n], ln_weight);
+  if (R2 > 0)
+  {
+    ln_R2_sum[n] = log_add (ln_R2_sum[n], ln_weight + log (double (R2)));
+  }
+  num_samples[n]++;
+}
+
+void
+LatticeWalk::rosenbluth (int num_tours)
+{
+  perm (num_tours, 0., HUGE_VAL);
+}
+
+void
+LatticeWalk::perm (int num_tours, double c_minus, double c_plus)
+{
+  const double ln_c_minus = log (c_minus);	// -infinity: never prune
+  const double ln_c_plus = log (c_plus);	// infinity: never copy
+  const double ln_2 = log (2.);
+  uint64_t free_keys[32];	// keys of the free neighbors (2*dim <= 32)
+  int free_dirs[32];
+
+  for (int tour = 0; tour < num_tours; tour++)
+  {
+    num_tours_total++;
+    double ln_tours = log (double (num_tours_total));
+    clear_sites ();
+    for (int a = 0; a < dim; a++)
+    {
+      path[a] = 0;
+    }
+    path_keys[0] = site_key (&path[0]);
+    insert_site (path_keys[0]);
+
+    int n = 0;
+    double ln_weight = 0.;
+    bool arrived = true;	// a new walk of n steps to record
+    while (n >= 0)
+    {
+      if (arrived)
+      {
+        record (n, ln_weight);
+        int copies = 1;
+        if (n == max_steps)
+        {
+          copies = 0;
+        }
+        else
+        {
+          double ln_ratio = ln_weight - (ln_weight_sum[n] - ln_tours);
+          if (ln_ratio > ln_c_plus)
+          {
+            copies = 2;		// enrich: two copies with half the weight
+            ln_weight -= ln_2;
+          }
+          else if (ln_ratio < ln_c_minus)
+          {
+            if (gsl_rng_uniform (rng_ptr) < 0.5)
+            {
+              copies = 0;	// prune
+            }
+            else
+            {
+              ln_weight += ln_2;	// survive with twice the weight
+            }
+          }
+        }
+        copies_left[n] = copies;
+        level_ln_weight[n] = ln_weight;
+        arrived = false;
+      }
+
+      if (copies_left[n] == 0)	// done with level n: go back one step
+      {
+        if (n > 0)
+        {
+          erase_site (path_keys[n]);
+        }
+        n--;
+        continue;
+      }
+      copies_left[n]--;
+
+      // grow one more step, to one of the m free neighbors
+      uint64_t key = path_keys[n];
+      int m = 0;
+      for (int k = 0; k < 2 * dim; k++)
+      {
+        uint64_t unit = uint64_t (1) << ((k / 2) * coord_bits);
+        uint64_t next_key = (k % 2 == 0 ? key + unit : key - unit);
+        if (!occupied (next_key))
+        {
+          free_keys[m] = next_key;
+          free_dirs[m] = k;
+          m++;
+        }
+      }
+      if (m == 0)		// trapped: no copy of this walk can grow
+      {
+        copies_left[n] = 0;
+        continue;
+      }
+      int choice = (m == 1 ? 0 : int (gsl_rng_uniform_int (rng_ptr, m)));
+      path_keys[n + 1] = free_keys[choice];
+      insert_site (path_keys[n + 1]);
+      int *site = &path[(size_t) (n + 1) * dim];
+      for (int a = 0; a < dim; a++)
+      {
+        site[a] = site[a - dim];
+      }
+      int k = free_dirs[choice];
+      site[k / 2] += (k % 2 == 0 ? 1 : -1);
+      ln_weight = level_ln_weight[n] + ln_m[m];
+      n++;
+      arrived = true;
+    }
+  }
+}
+
+//********************************************************************
+// Estimates from all tours so far
+
+double
+LatticeWalk::ln_count (int n)
+{
+  return (ln_weight_sum[n] - log (double (num_tours_total)));
+}
+
+double
+LatticeWalk::mean_square_distance (int n)
+{
+  return (exp (ln_R2_sum[n] - ln_weight_sum[n]));
+}
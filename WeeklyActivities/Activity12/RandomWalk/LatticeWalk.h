@@ -0,0 +1,97 @@
+//  file: LatticeWalk.h
+//
+//  Header file for LatticeWalk class: random walks and self-avoiding
+//   walks (SAWs) on the hypercubic lattice in dim dimensions (square
+//   lattice for dim = 2, cubic for dim = 3)
+//
+//  Revision history:
+//      05/31/21  original version
+//
+//  Notes:
+//   * the occupied sites of the current walk are kept in an
+//      open-addressing hash set (linear probing) that is allocated once,
+//      for max_steps, in the constructor.  It is emptied between walks by
+//      bumping a stamp, so no memory is allocated or cleared per step or
+//      per walk.
+//   * a site is stored as one 64-bit key with 64/dim bits per
+//      coordinate, so max_steps must be less than 2^(64/dim - 1).
+//   * self_avoiding_walk() is simple sampling: the walk is thrown away
+//      as soon as it hits itself, so almost every long walk is rejected.
+//      rosenbluth() and perm() grow walks by choosing only among the free
+//      neighbors, and weight each one by the product of the numbers of
+//      free neighbors (Rosenbluth); PERM (Grassberger, PRE 56, 3682)
+//      also makes copies of walks with large weights and prunes walks
+//      with small ones, so that long SAWs keep a useful weight.
+//   * the weighted sums are kept as logarithms, so the weights (which
+//      grow like mu^n, mu = 2.638 for the square lattice) never overflow.
+//
+#ifndef LATTICE_WALK_H
+#define LATTICE_WALK_H
+
+#include <vector>
+#include <stdint.h>
+
+#include <gsl/gsl_rng.h>	// GSL random number generators
+
+class LatticeWalk
+{
+public:
+  LatticeWalk (int dim, int max_steps, unsigned long int seed);
+  ~LatticeWalk ();
+
+  // a walk of num_steps from the origin; these return the final R^2
+  long random_walk (int num_steps);	// may revisit sites
+  long self_avoiding_walk (int num_steps);	// -1 if rejected
+
+  // num_tours more walks of up to max_steps (Rosenbluth), or tours of
+  //  PERM with copying above c_plus and pruning below c_minus times the
+  //  current estimate of the number of walks
+  void rosenbluth (int num_tours);
+  void perm (int num_tours, double c_minus = 0.3, double c_plus = 3.);
+  void clear_statistics ();
+
+  // estimates from the tours so far, for 0 <= n <= max_steps
+  double ln_count (int n);	// ln of the number of SAWs of n steps
+  double mean_square_distance (int n);	// <R^2> of SAWs of n steps
+  long long get_num_samples (int n) { return num_samples[n]; };
+  long long get_num_tours () { return num_tours_total; };
+
+  int get_dim () { return dim; };
+  int get_max_steps () { return max_steps; };
+
+private:
+  uint64_t site_key (const int *site);
+  void clear_sites ();
+  bool insert_site (uint64_t key);	// false if already occupied
+  bool occupied (uint64_t key);
+  void erase_site (uint64_t key);
+
+  void record (int n, double ln_weight);	// add walk path[0..n]
+
+  int dim;
+  int max_steps;
+  int coord_bits;		// bits per coordinate in a key
+
+  // hash set of occupied sites: slot i is in use if stamp[i] == current
+  std::vector<uint64_t> keys;
+  std::vector<unsigned int> stamp;
+  unsigned int current;
+  uint64_t mask;		// number of slots - 1 (a power of 2)
+  int hash_shift;
+
+  std::vector<int> path;	// sites of the current walk, dim per site
+  std::vector<uint64_t> path_keys;	// and their keys
+  std::vector<int> copies_left;	// PERM: copies still to grow, per level
+  std::vector<double> level_ln_weight;	// PERM: weight at each level
+  std::vector<double> ln_m;	// ln of the number of free neighbors
+
+  // weighted statistics for each length n
+  std::vector<double> ln_weight_sum;	// ln sum of weights
+  std::vector<double> ln_R2_sum;	// ln sum of weight * R^2
+  std::vector<long long> num_samples;
+  long long num_tours_total;
+
+  gsl_rng *rng_ptr;		// pointer to random number generator (rng)
+};
+
+#endif
@@ -0,0 +1,168 @@
+//  file: LatticeWalk_test.cpp
+//
+//  Test program for LatticeWalk class: self-avoiding walks on the
+//   square (dim = 2) or cubic (dim = 3) lattice by simple sampling,
+//   Rosenbluth and PERM
+//
+//  Revision history:
+//      05/31/21  original version
+//      06/01/21  seed from RngStreams
+//
+//  Notes:
+//   * the numbers of SAWs c_n for small n are compared with the exact
+//      counts (square lattice: 4, 12, 36, 100, ...; cubic: 6, 30, 150,
+//      726, ...).
+//   * <R^2> ~ n^(2 nu) with nu = 3/4 in 2D and 0.588 in 3D (1/2 for an
+//      ordinary random walk); the effective nu from n/2 to n is printed.
+//   * simple sampling keeps a fraction c_n/(2 dim)^n of the walks, so
+//      for n much beyond 50 in 2D essentially every walk is rejected.
+//      Rosenbluth walks are lost only when they trap themselves (after
+//      about 70 steps on average in 2D), but their weights spread out
+//      over many orders of magnitude; PERM keeps them together and makes
+//      up for the trapped walks by copying the others.
+//   * output to LatticeWalk_test.dat: n, ln c_n and <R^2> from PERM,
+//      <R^2> from Rosenbluth (0 if none got that far), and the number of
+//      PERM samples
+//   * compile with make -f make_LatticeWalk_test
+//
+//******************************************************************
+
+// include files
+#include <iostream>		// cout and cin
+#include <iomanip>		// manipulators like setprecision
+#include <fstream>		// file input and output
+#include <cmath>
+#include <ctime>
+using namespace std;		// we need this when .h is omitted
+
+#include "LatticeWalk.h"
+#include "RngStreams.h"		// master seed and streams
+
+//********************************************************************
+int
+main (void)
+{
+  int dim, max_steps, num_tours;
+
+  cout << "Dimension (2 = square, 3 = cubic lattice): ";
+  cin >> dim;
+  cout << "Length of the walks (e.g. 1000): ";
+  cin >> max_steps;
+  cout << "Number of tours (e.g. 10000): ";
+  cin >> num_tours;
+  unsigned long int seed =
+    RngStreams::stream_seed (RngStreams::next_stream ());
+
+  const long long exact_2d[] = { 1, 4, 12, 36, 100, 284, 780, 2172, 5916,
+    16268, 44100
+  };
+  const long long exact_3d[] = { 1, 6, 30, 150, 726, 3534, 16926, 81390,
+    387966, 1853886, 8809878
+  };
+
+  LatticeWalk walk (dim, max_steps, seed);
+
+  // 0. ordinary lattice walks, for which <R^2> = n exactly
+  double sum_R2_walk = 0.;
+  for (int i = 0; i < 10000; i++)
+  {
+    sum_R2_walk += walk.random_walk (max_steps);
+  }
+  cout << "ordinary walks: <R^2>/n = " << fixed << setprecision (3)
+       << sum_R2_walk / 10000. / max_steps << " (exact: 1)" << endl;
+
+  // 1. simple sampling: how many walks of each length survive?
+  int num_simple = 100000;
+  cout << "simple sampling, " << num_simple << " walks:" << endl;
+  for (int n = 10; n <= max_steps; n *= 2)
+  {
+    int accepted = 0;
+    double sum_R2 = 0.;
+    for (int i = 0; i < num_simple; i++)
+    {
+      long R2 = walk.self_avoiding_walk (n);
+      if (R2 >= 0)
+      {
+        accepted++;
+        sum_R2 += R2;
+      }
+    }
+    cout << setw (6) << n << "  accepted " << setw (6) << accepted;
+    if (accepted > 0)
+    {
+      cout << "   <R^2> = " << fixed << setprecision (2)
+           << sum_R2 / accepted;
+    }
+    cout << endl;
+  }
+
+  // 2. Rosenbluth
+  clock_t start = clock ();
+  walk.rosenbluth (num_tours);
+  double rosenbluth_time = double (clock () - start) / CLOCKS_PER_SEC;
+  vector<double> R2_rosenbluth (max_steps + 1);
+  for (int n = 0; n <= max_steps; n++)
+  {
+    R2_rosenbluth[n] = (walk.get_num_samples (n) > 0 ?
+                        walk.mean_square_distance (n) : 0.);
+  }
+  cout << "Rosenbluth: " << setprecision (2) << rosenbluth_time << " s, "
+       << walk.get_num_samples (max_steps) << " of " << num_tours
+       << " walks reached n = " << max_steps << endl;
+
+  // 3. PERM
+  walk.clear_statistics ();
+  start = clock ();
+  walk.perm (num_tours);
+  double perm_time = double (clock () - start) / CLOCKS_PER_SEC;
+  cout << "PERM:       " << setprecision (2) << perm_time << " s, "
+       << walk.get_num_samples (max_steps) << " samples at n = "
+       << max_steps << endl;
+
+  if (dim == 2 || dim == 3)
+  {
+    cout << "   n   c_n (PERM)       exact" << endl;
+    for (int n = 1; n <= 10 && n <= max_steps; n++)
+    {
+      cout << setw (4) << n << "  " << setw (12) << setprecision (1)
+           << exp (walk.ln_count (n)) << "  " << setw (10)
+           << (dim == 2 ? exact_2d[n] : exact_3d[n]) << endl;
+    }
+  }
+
+  cout << "     n     <R^2> PERM   <R^2> Rosenbluth   nu (PERM)" << endl;
+  for (int n = 16; n <= max_steps; n *= 2)
+  {
+    double nu = 0.5 * log (walk.mean_square_distance (n)
+                           / walk.mean_square_distance (n / 2)) / log (2.);
+    cout << setw (6) << n << "  " << setprecision (2) << setw (12)
+         << walk.mean_square_distance (n) << "  " << setw (14);
+    if (R2_rosenbluth[n] > 0.)
+    {
+      cout << R2_rosenbluth[n];
+    }
+    else
+    {
+      cout << "-";		// no Rosenbluth walk got this far
+    }
+    cout << "  " << setw (12) << setprecision (3) << nu << endl;
+  }
+
+  ofstream out;
+  out.open ("LatticeWalk_test.dat");
+  out << "# self-avoiding walks in " << dim << " dimensions, " << num_tours
+      << " tours" << endl;
+  out << "#   n      ln c_n       <R^2> PERM   <R^2> Rosenbluth  samples"
+      << endl;
+  for (int n = 1; n <= max_steps; n++)
+  {
+    out << setw (6) << n << "  " << scientific << setprecision (6)
+        << setw (13) << walk.ln_count (n) << "  " << setw (13)
+        << walk.mean_square_distance (n) << "  " << setw (13)
+        << R2_rosenbluth[n] << "  " << walk.get_num_samples (n) << endl;
+  }
+  out.close ();
+  cout << "Output to LatticeWalk_test.dat." << endl;
+
+  return (0);
+}
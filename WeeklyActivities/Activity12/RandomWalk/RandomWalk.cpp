@@ -6,6 +6,8 @@
 //
 //  Revision history:
 //      05/24/04  switched random_walk.cpp to define a RandomWalk class
+//      06/01/21  each walk gets the next stream from RngStreams instead
+//                 of two calls to random_seed() (one file open each)
 //
 //  Notes:
 //   * implements method 2 from the list in section 6.10
@@ -24,9 +26,7 @@
 #include <cmath>
 
 #include "RandomWalk.h"
-
-// function prototypes
-extern unsigned long int random_seed ();	// routine to generate a seed
+#include "RngStreams.h"		// seeds and streams for the GSL generators
 
 //********************************************************************
 
@@ -35,8 +35,6 @@ RandomWalk::RandomWalk (double x0, double y0)
 {
   npts = 1;			// start with one point
 
-  unsigned long int seed = random_seed ();	// seed for rng
-
   // initialize step size
   lower_limit = -sqrt (2.);	// lower limit of uniform range 
   upper_limit = sqrt (2.);	// upper limit of uniform range 
@@ -46,9 +44,8 @@ RandomWalk::RandomWalk (double x0, double y0)
   delta_x = 0.;			// uniform random number from a to b 
   delta_y = 0.;			// 2nd uniform random number from a to b 
 
-  rng_ptr = gsl_rng_alloc (gsl_rng_taus);	// allocate the rng 
-  seed = random_seed ();	// generate a seed
-  gsl_rng_set (rng_ptr, seed);	// seed the rng 
+  // allocate an rng seeded for a stream of its own
+  rng_ptr = RngStreams::new_rng (RngStreams::next_stream ());
 }
 
 // Destructor for RandomWalk
@@ -0,0 +1,313 @@
+//  file: RandomWalkEnsemble.cpp
+//
+//  Member functions for RandomWalkEnsemble class that advances many
+//   random walks at once
+//
+//  Revision history:
+//      05/29/21  original version
+//
+//  Notes:
+//   * xoshiro256+ (Blackman and Vigna): four 64-bit words of state, only
+//      shifts, xors and adds, so `lanes' copies of it in parallel arrays
+//      vectorize.  The top 52 bits of a number become a double in [1,2)
+//      by setting the exponent bits (the 1 is folded into the offset of
+//      the step), which avoids an integer-to-double conversion.
+//   * jump() advances a state by 2^128 numbers; state k (chunk k/lanes,
+//      lane k%lanes) is the seeded state jumped k times.
+//   * the seed goes through SplitMix64 to fill the first state, as the
+//      xoshiro authors recommend.
+//   * step(num_steps) keeps each group of `lanes' walkers in registers
+//      for all num_steps steps, so it is much faster than calling
+//      step() num_steps times (which streams the arrays through memory
+//      every step), but uses the random numbers in a different order.
+//   * compile with -fopenmp to run the chunks on several threads, and
+//      -O3 (or -O2 -ftree-vectorize) for the vectorized loops; with
+//      -march=native on an AVX2 machine a step takes about 0.6 ns per
+//      core, vs. about 2 ns with the default SSE2 and 70 ns for
+//      RandomWalk::step() with GSL.
+//
+//******************************************************************
+
+// include files
+#include <cmath>
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "RandomWalkEnsemble.h"
+
+//********************************************************************
+// SplitMix64 generator, used only to fill the first xoshiro state
+static inline uint64_t
+splitmix64 (uint64_t &z)
+{
+  uint64_t r = (z += 0x9e3779b97f4a7c15ULL);
+  r = (r ^ (r >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  r = (r ^ (r >> 27)) * 0x94d049bb133111ebULL;
+  return (r ^ (r >> 31));
+}
+
+static inline uint64_t
+rotl (uint64_t v, int k)
+{
+  return ((v << k) | (v >> (64 - k)));
+}
+
+// one xoshiro256+ step of s[0..3]
+static inline uint64_t
+next (uint64_t s[4])
+{
+  uint64_t result = s[0] + s[3];
+  uint64_t t = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl (s[3], 45);
+  return (result);
+}
+
+// advance s[0..3] by 2^128 steps
+static void
+jump (uint64_t s[4])
+{
+  static const uint64_t jump_poly[4] = {
+    0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+    0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+  };
+  uint64_t t[4] = { 0, 0, 0, 0 };
+  for (int w = 0; w < 4; w++)
+  {
+    for (int b = 0; b < 64; b++)
+    {
+      if (jump_poly[w] & (1ULL << b))
+      {
+        for (int k = 0; k < 4; k++)
+        {
+          t[k] ^= s[k];
+        }
+      }
+      next (s);
+    }
+  }
+  for (int k = 0; k < 4; k++)
+  {
+    s[k] = t[k];
+  }
+}
+
+// u in [1,2) from the top 52 bits of a random number, by setting the
+//  exponent bits
+static inline double
+to_unit (uint64_t r)
+{
+  uint64_t bits = (r >> 12) | 0x3ff0000000000000ULL;
+  double u;
+  memcpy (&u, &bits, sizeof (u));
+  return (u);
+}
+
+//********************************************************************
+// Constructor for RandomWalkEnsemble
+RandomWalkEnsemble::RandomWalkEnsemble (int num_walkers_in,
+                                        unsigned long int seed,
+                                        double x0, double y0)
+{
+  num_walkers = num_walkers_in;
+  num_chunks = (num_walkers + chunk_size - 1) / chunk_size;
+  threads = 0;
+
+  // initialize step size
+  lower_limit = -sqrt (2.);	// lower limit of uniform range
+  upper_limit = sqrt (2.);	// upper limit of uniform range
+
+  int padded = (num_walkers + lanes - 1) / lanes * lanes;
+  x.assign (padded, x0);
+  y.assign (padded, y0);
+  npts = 1;			// start with one point, as RandomWalk
+
+  // one seed, then jumps: state of chunk c, lane l is jump^(c*lanes+l)
+  uint64_t z = seed;
+  uint64_t s[4];
+  for (int k = 0; k < 4; k++)
+  {
+    s[k] = splitmix64 (z);
+  }
+  state.resize ((size_t) num_chunks * 4 * lanes);
+  for (int c = 0; c < num_chunks; c++)
+  {
+    for (int l = 0; l < lanes; l++)
+    {
+      for (int k = 0; k < 4; k++)
+      {
+        state[((size_t) c * 4 + k) * lanes + l] = s[k];
+      }
+      jump (s);
+    }
+  }
+}
+
+// Put every walker back at (x0,y0); the streams continue
+void
+RandomWalkEnsemble::reset (double x0, double y0)
+{
+  x.assign (x.size (), x0);
+  y.assign (y.size (), y0);
+  npts = 1;
+}
+
+//********************************************************************
+// num_steps steps for the walkers of one chunk
+void
+RandomWalkEnsemble::advance (int chunk, int num_steps)
+{
+  uint64_t s0[lanes], s1[lanes], s2[lanes], s3[lanes];
+  uint64_t *s = &state[(size_t) chunk * 4 * lanes];
+  for (int l = 0; l < lanes; l++)
+  {
+    s0[l] = s[l];
+    s1[l] = s[lanes + l];
+    s2[l] = s[2 * lanes + l];
+    s3[l] = s[3 * lanes + l];
+  }
+  const double width = upper_limit - lower_limit;
+  const double offset = lower_limit - width;	// u in [1,2) -> step
+
+  int begin = chunk * chunk_size;
+  int end = begin + chunk_size;
+  end = (end > int (x.size ()) ? int (x.size ()) : end);
+  for (int i = begin; i < end; i += lanes)
+  {
+    double xl[lanes], yl[lanes];
+    for (int l = 0; l < lanes; l++)
+    {
+      xl[l] = x[i + l];
+      yl[l] = y[i + l];
+    }
+    for (int t = 0; t < num_steps; t++)
+    {
+      for (int l = 0; l < lanes; l++)
+      {
+        // two xoshiro256+ steps of lane l, one for x and one for y
+        uint64_t rx = s0[l] + s3[l];
+        uint64_t tmp = s1[l] << 17;
+        s2[l] ^= s0[l];
+        s3[l] ^= s1[l];
+        s1[l] ^= s2[l];
+        s0[l] ^= s3[l];
+        s2[l] ^= tmp;
+        s3[l] = rotl (s3[l], 45);
+
+        uint64_t ry = s0[l] + s3[l];
+        tmp = s1[l] << 17;
+        s2[l] ^= s0[l];
+        s3[l] ^= s1[l];
+        s1[l] ^= s2[l];
+        s0[l] ^= s3[l];
+        s2[l] ^= tmp;
+        s3[l] = rotl (s3[l], 45);
+
+        xl[l] += offset + width * to_unit (rx);
+        yl[l] += offset + width * to_unit (ry);
+      }
+    }
+    for (int l = 0; l < lanes; l++)
+    {
+      x[i + l] = xl[l];
+      y[i + l] = yl[l];
+    }
+  }
+
+  for (int l = 0; l < lanes; l++)
+  {
+    s[l] = s0[l];
+    s[lanes + l] = s1[l];
+    s[2 * lanes + l] = s2[l];
+    s[3 * lanes + l] = s3[l];
+  }
+}
+
+// Take a single random step with every walker
+void
+RandomWalkEnsemble::step ()
+{
+  step (1);
+}
+
+// Take num_steps random steps with every walker
+void
+RandomWalkEnsemble::step (int num_steps)
+{
+  int c;
+#ifdef _OPENMP
+  int num_threads = (threads > 0 ? threads : omp_get_max_threads ());
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+#endif
+  for (c = 0; c < num_chunks; c++)
+  {
+    advance (c, num_steps);
+  }
+  npts += num_steps;		// increment the point counter
+}
+
+//********************************************************************
+// Averages are summed chunk by chunk, then over the chunks in order, so
+//  they do not depend on the number of threads
+double
+RandomWalkEnsemble::mean_distance ()
+{
+  std::vector<double> partial (num_chunks, 0.);
+  int c;
+#ifdef _OPENMP
+  int num_threads = (threads > 0 ? threads : omp_get_max_threads ());
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+#endif
+  for (c = 0; c < num_chunks; c++)
+  {
+    int end = (c + 1) * chunk_size;
+    end = (end > num_walkers ? num_walkers : end);
+    double sum = 0.;
+    for (int i = c * chunk_size; i < end; i++)
+    {
+      sum += sqrt (x[i] * x[i] + y[i] * y[i]);
+    }
+    partial[c] = sum;
+  }
+  double sum = 0.;
+  for (c = 0; c < num_chunks; c++)
+  {
+    sum += partial[c];
+  }
+  return (sum / double (num_walkers));
+}
+
+double
+RandomWalkEnsemble::mean_square_distance ()
+{
+  std::vector<double> partial (num_chunks, 0.);
+  int c;
+#ifdef _OPENMP
+  int num_threads = (threads > 0 ? threads : omp_get_max_threads ());
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+#endif
+  for (c = 0; c < num_chunks; c++)
+  {
+    int end = (c + 1) * chunk_size;
+    end = (end > num_walkers ? num_walkers : end);
+    double sum = 0.;
+    for (int i = c * chunk_size; i < end; i++)
+    {
+      sum += x[i] * x[i] + y[i] * y[i];
+    }
+    partial[c] = sum;
+  }
+  double sum = 0.;
+  for (c = 0; c < num_chunks; c++)
+  {
+    sum += partial[c];
+  }
+  return (sum / double (num_walkers));
+}
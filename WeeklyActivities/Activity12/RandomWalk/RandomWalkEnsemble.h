@@ -0,0 +1,69 @@
+//  file: RandomWalkEnsemble.h
+//
+//  Header file for RandomWalkEnsemble class: many two-dimensional random
+//   walks (the steps of RandomWalk) advanced together
+//
+//  Revision history:
+//      05/29/21  original version
+//
+//  Notes:
+//   * the coordinates are stored as two arrays x[] and y[] (one entry
+//      per walker) instead of one RandomWalk object per walker, so a step
+//      of the whole ensemble is a simple loop the compiler can vectorize.
+//   * the walkers are split into chunks of chunk_size; each chunk has
+//      its own xoshiro256+ generator with `lanes' interleaved states, one
+//      for each of `lanes' walkers advanced side by side.  Every state
+//      is the one before it jumped ahead by 2^128 numbers, all from a
+//      single seed, so the streams never overlap, and the chunks can run
+//      on different OpenMP threads with the same result.
+//   * a step is uniform in [lower_limit,upper_limit] in x and in y, as
+//      in RandomWalk.
+//
+#ifndef RANDOM_WALK_ENSEMBLE_H
+#define RANDOM_WALK_ENSEMBLE_H
+
+#include <vector>
+#include <stdint.h>
+
+class RandomWalkEnsemble
+{
+public:
+  // num_walkers walks starting at (x0,y0), with all the streams derived
+  //  from seed
+  RandomWalkEnsemble (int num_walkers, unsigned long int seed,
+                      double x0 = 0., double y0 = 0.);
+
+  void reset (double x0 = 0., double y0 = 0.);	// back to the start
+  void set_threads (int num_threads) { threads = num_threads; };	// 0 = all
+
+  void step ();			// every walker takes one step
+  void step (int num_steps);	// every walker takes num_steps steps
+
+  int get_num_walkers () { return num_walkers; };
+  long long get_npts () { return npts; };	// steps per walker so far
+  double get_x (int i) { return x[i]; };
+  double get_y (int i) { return y[i]; };
+
+  double mean_distance ();	// average of sqrt(x^2 + y^2)
+  double mean_square_distance ();	// average of x^2 + y^2
+
+  static const int lanes = 8;	// walkers advanced side by side
+  static const int chunk_size = 4096;	// walkers per rng stream
+
+private:
+  void advance (int chunk, int num_steps);
+
+  int num_walkers;
+  int num_chunks;
+  int threads;			// OpenMP threads for step(), 0 = all
+  long long npts;		// steps per walker so far
+
+  double lower_limit;		// lower limit of uniform range of step size
+  double upper_limit;		// upper limit of uniform range of step size
+
+  std::vector<double> x;	// current x values, padded to a whole lane
+  std::vector<double> y;	// current y values
+  std::vector<uint64_t> state;	// [chunk][word 0..3][lane] xoshiro256+
+};
+
+#endif
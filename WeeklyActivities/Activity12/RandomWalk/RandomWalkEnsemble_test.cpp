@@ -0,0 +1,119 @@
+//  file: RandomWalkEnsemble_test.cpp
+//
+//  Test program for RandomWalkEnsemble class: the random_walk_length.cpp
+//   experiment (average distance after npts steps for npts = 10 to
+//   100000) with a large ensemble of walkers, and a comparison of the
+//   time per step with the one-object-per-walker RandomWalk class
+//
+//  Revision history:
+//      05/29/21  original version
+//      06/01/21  seed from RngStreams
+//
+//  Notes:
+//   * a step is uniform in [-sqrt(2),sqrt(2)] in x and y, with variance
+//      2/3 each, so <R^2> = (4/3) npts and, for large npts, where the
+//      end points are gaussian, <R> = sqrt(pi/4 <R^2>) = 1.0233 sqrt(npts)
+//   * output goes to RandomWalkEnsemble_test.dat: npts, <R>, sqrt(<R^2>)
+//      and the statistical error of <R>
+//   * compile with make -f make_RandomWalkEnsemble_test (needs -fopenmp)
+//
+//******************************************************************
+
+// include files
+#include <iostream>		// cout and cin
+#include <iomanip>		// manipulators like setprecision
+#include <fstream>		// file input and output
+#include <cmath>
+using namespace std;		// we need this when .h is omitted
+#include <omp.h>
+
+#include "RandomWalk.h"
+#include "RandomWalkEnsemble.h"
+#include "RngStreams.h"		// master seed and streams
+
+//********************************************************************
+int
+main (void)
+{
+  int num_walkers;
+  int num_threads;
+
+  cout << "How many walkers (e.g. 100000)? ";
+  cin >> num_walkers;
+  cout << "Number of threads (0 = all): ";
+  cin >> num_threads;
+  // the only seed, from a stream of the master seed
+  unsigned long int seed =
+    RngStreams::stream_seed (RngStreams::next_stream ());
+
+  RandomWalkEnsemble ensemble (num_walkers, seed);
+  ensemble.set_threads (num_threads);
+
+  // 1. one RandomWalk object per walker, as before (fewer walkers)
+  int num_old = 1000;
+  int old_steps = 1000;
+  double start = omp_get_wtime ();
+  double sum_R = 0.;
+  for (int i = 0; i < num_old; i++)
+  {
+    RandomWalk walk (0., 0.);
+    for (int j = 0; j < old_steps; j++)
+    {
+      walk.step ();
+    }
+    sum_R += sqrt (walk.get_x () * walk.get_x ()
+                   + walk.get_y () * walk.get_y ());
+  }
+  double old_ns = (omp_get_wtime () - start) * 1.e9
+                  / (double (num_old) * old_steps);
+  cout << "RandomWalk objects:  " << fixed << setprecision (2) << old_ns
+       << " ns per step (<R>/sqrt(npts) = " << setprecision (4)
+       << sum_R / num_old / sqrt (double (old_steps)) << ")" << endl;
+
+  // 2. the ensemble, one step() per step
+  start = omp_get_wtime ();
+  for (int j = 0; j < old_steps; j++)
+  {
+    ensemble.step ();
+  }
+  double single_ns = (omp_get_wtime () - start) * 1.e9
+                     / (double (num_walkers) * old_steps);
+  cout << "ensemble, step():    " << setprecision (3) << single_ns
+       << " ns per step (<R>/sqrt(npts) = " << setprecision (4)
+       << ensemble.mean_distance () / sqrt (double (old_steps)) << ")"
+       << endl;
+
+  // 3. the random_walk_length.cpp experiment with step(npts)
+  ofstream out;
+  out.open ("RandomWalkEnsemble_test.dat");
+  out << "# " << num_walkers << " walkers" << endl;
+  out << "#  npts     <R>         sqrt(<R^2>)    error of <R>" << endl;
+  long long total_steps = 0;
+  start = omp_get_wtime ();
+  for (int npts = 10; npts <= 100000; npts *= 2)
+  {
+    ensemble.reset ();
+    ensemble.step (npts);
+    total_steps += (long long) npts * num_walkers;
+
+    double R_avg = ensemble.mean_distance ();
+    double R2_avg = ensemble.mean_square_distance ();
+    double error = sqrt ((R2_avg - R_avg * R_avg) / num_walkers);
+    out << setw (6) << npts << "  " << fixed << setprecision (6)
+        << setw (12) << R_avg << "  " << setw (12) << sqrt (R2_avg)
+        << "  " << scientific << setprecision (3) << error << endl;
+    cout << setw (6) << npts << "   <R>/sqrt(npts) = " << fixed
+         << setprecision (4) << R_avg / sqrt (double (npts)) << " +/- "
+         << error / sqrt (double (npts)) << "  (expect 1.0233)" << endl;
+  }
+  double elapsed = omp_get_wtime () - start;
+  out.close ();
+  cout << "ensemble, step(npts): " << setprecision (3)
+       << total_steps / elapsed * 1.e-9 << " billion steps per second ("
+       << setprecision (2) << elapsed << " s, "
+       << (num_threads > 0 ? num_threads : omp_get_max_threads ())
+       << " threads)" << endl;
+  cout << "Output to RandomWalkEnsemble_test.dat." << endl;
+
+  return (0);
+}
@@ -0,0 +1,90 @@
+//  file: RngStreams.h
+//
+//  Header file for the RngStreams class: one master seed per run of a
+//   program, and as many independent GSL random number streams derived
+//   from it as the program needs.  All members are static, so there is
+//   one set of streams per process and no RngStreams object is needed.
+//
+//  Revision history:
+//      06/01/21  original version
+//      06/06/21  xoshiro256+ generator type, so streams cannot collide
+//      06/07/21  no OpenMP in RngStreams.cpp; thread_rng() inline
+//
+//  Notes:
+//   * the master seed is set by init(seed), or on first use from the
+//      RNG_SEED environment variable, or else from /dev/urandom (read
+//      once, instead of once per object as with random_seed()).  It is
+//      printed, so any run can be repeated with RNG_SEED=<master seed>.
+//   * stream k is seeded with a SplitMix64 hash of (master seed, k), so
+//      it depends only on k, not on when or on which thread the stream
+//      is made.  The hash is one-to-one in k, so different streams
+//      always get different 64-bit seeds.
+//   * the generators are of type xoshiro_type, xoshiro256+ (as in
+//      BulkRng) wrapped as a GSL generator, with 256 bits of state filled
+//      from the whole 64-bit seed.  GSL's own generators (e.g. taus) use
+//      only seed mod 2^32, so with them two of a few 10^5 streams are
+//      likely to be the very same sequence.  Different xoshiro256+ states
+//      are different sequences, and with a period of 2^256 - 1 the chance
+//      that two streams overlap in a run is negligible.  (Stream numbers
+//      like npts*2^32 + trial are too large to reach with jumps of one
+//      long stream, hence hashed states rather than jumps.)
+//   * gsl_rng_get gives the upper 32 bits of each number (gsl_rng_max =
+//      2^32 - 1, as for taus) and gsl_rng_uniform the upper 53 bits.
+//   * new_rng(k) allocates a generator for stream k, which the caller
+//      frees; set_stream(rng, k) restarts a generator as stream k.
+//      next_stream() hands out 0, 1, 2, ... to objects that each need
+//      their own stream (e.g. RandomWalk).  With another type passed to
+//      new_rng the streams are only distinct mod 2^32.
+//   * thread_rng() is a generator that belongs to the calling thread:
+//      stream thread_stream_base + (OpenMP thread number), allocated on
+//      first use and freed when the thread ends.  A program without
+//      threads just calls it once in main.  It is inline, so that the
+//      thread number comes from the caller, compiled with or without
+//      -fopenmp, and RngStreams.o itself never needs libgomp.
+//
+#ifndef RNG_STREAMS_H
+#define RNG_STREAMS_H
+
+#include <atomic>
+
+#include <gsl/gsl_rng.h>	// GSL random number generators
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+class RngStreams
+{
+public:
+  static void init (unsigned long int seed = 0);	// 0: RNG_SEED or urandom
+  static unsigned long int master_seed ();
+
+  static unsigned long int stream_seed (unsigned long long stream);
+  static gsl_rng *new_rng (unsigned long long stream,
+                           const gsl_rng_type *type = xoshiro_type);
+  static void set_stream (gsl_rng *rng_ptr, unsigned long long stream);
+  static unsigned long long next_stream ();
+
+  // owned by RngStreams, do not free
+  static gsl_rng *thread_rng ()
+  {
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num ();
+#endif
+    return (make_thread_rng (thread));
+  };
+
+  static const unsigned long long thread_stream_base = 1ULL << 62;
+  static const gsl_rng_type *xoshiro_type;	// the default generator
+
+private:
+  static gsl_rng *make_thread_rng (int thread);
+  static void set_master (unsigned long int seed);
+
+  static std::atomic<bool> initialized;
+  static unsigned long int master;
+  static std::atomic<unsigned long long> stream_counter;	// next_stream()
+};
+
+#endif
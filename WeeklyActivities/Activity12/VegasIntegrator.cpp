@@ -0,0 +1,412 @@
+//  file: VegasIntegrator.cpp
+//
+//  Member functions for VegasIntegrator class
+//
+//  Revision history:
+//      06/03/21  original version
+//
+//  Notes:
+//   * the grid is xi[k*dim + j], k = 0..bins, the edges of the bins of
+//      coordinate j in units of the width of the region; d[k*dim + j]
+//      collects the sum of f^2 in bin k of coordinate j, from which
+//      refine_grid() moves the edges so that each bin gets about the
+//      same share (damped by alpha).  The functions follow the ones in
+//      GSL's monte/vegas.c.
+//   * in stratified mode (many calls per coordinate) there are several
+//      boxes per bin, all the points of a box are in the same bins, and
+//      d gets the variance of each box instead of the f^2 of each point.
+//   * a point of box b: coordinate j is the grid bin k = int(z) with
+//      z = (box_j + u) bins/boxes, u uniform in [0,1), and goes through
+//      bin k linearly; its weight is the product of the bin widths.
+//   * a chunk makes the points of a block of boxes at once (in the
+//      x[k*n + i] order of an mc_batch_function), then calls func.f once
+//      for the whole block.
+//
+//******************************************************************
+
+// include files
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "VegasIntegrator.h"
+#include "BulkRng.h"
+
+// SplitMix64 finalizer, to make a seed for each chunk
+static inline unsigned long long
+mix64 (unsigned long long z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return (z ^ (z >> 31));
+}
+
+//********************************************************************
+// Constructor for VegasIntegrator
+VegasIntegrator::VegasIntegrator (size_t dim_in, unsigned long int seed_in)
+{
+  dim = dim_in;
+  seed = seed_in;
+  threads = 0;
+  iterations = 5;		// GSL defaults
+  alpha = 1.5;
+  iteration_count = 0;
+
+  stratified = false;
+  bins = 1;
+  boxes = 1;
+  calls_per_box = 2;
+  jac = vol = 1.;
+  delx.resize (dim);
+  xi.resize ((bins_max + 1) * dim);
+  xin.resize (bins_max + 1);
+  d.resize (bins_max * dim);
+  weight.resize (bins_max);
+  grid_ready = false;
+
+  sum_wgts = wtd_int_sum = chisq = 0.;
+  samples = 0;
+  iteration_result = iteration_sigma = 0.;
+}
+
+//********************************************************************
+// One bin from 0 to 1 in each coordinate
+void
+VegasIntegrator::init_grid (const double xl[], const double xu[])
+{
+  vol = 1.;
+  bins = 1;
+  for (size_t j = 0; j < dim; j++)
+  {
+    delx[j] = xu[j] - xl[j];
+    vol *= delx[j];
+    xi[j] = 0.;
+    xi[dim + j] = 1.;
+  }
+}
+
+// Split the present bins evenly into new_bins bins
+void
+VegasIntegrator::resize_grid (int new_bins)
+{
+  double w = double (bins) / double (new_bins);
+  for (size_t j = 0; j < dim; j++)
+  {
+    double xold;
+    double xnew = 0.;
+    double dw = 0.;
+    int i = 1;
+    for (int k = 1; k <= bins; k++)
+    {
+      dw += 1.;
+      xold = xnew;
+      xnew = xi[k * dim + j];
+      for (; dw > w; i++)
+      {
+        dw -= w;
+        xin[i] = xnew - (xnew - xold) * dw;
+      }
+    }
+    for (int k = 1; k < new_bins; k++)
+    {
+      xi[k * dim + j] = xin[k];
+    }
+    xi[new_bins * dim + j] = 1.;
+  }
+  bins = new_bins;
+}
+
+// New bin edges from the distribution d of the last iteration
+void
+VegasIntegrator::refine_grid ()
+{
+  for (size_t j = 0; j < dim; j++)
+  {
+    // smooth: d[i] = (d[i-1] + d[i] + d[i+1])/3
+    double oldg = d[j];
+    double newg = d[dim + j];
+    d[j] = (oldg + newg) / 2.;
+    double grid_tot_j = d[j];
+    for (int i = 1; i < bins - 1; i++)
+    {
+      double rc = oldg + newg;
+      oldg = newg;
+      newg = d[(i + 1) * dim + j];
+      d[i * dim + j] = (rc + newg) / 3.;
+      grid_tot_j += d[i * dim + j];
+    }
+    d[(bins - 1) * dim + j] = (newg + oldg) / 2.;
+    grid_tot_j += d[(bins - 1) * dim + j];
+
+    double tot_weight = 0.;
+    for (int i = 0; i < bins; i++)
+    {
+      weight[i] = 0.;
+      if (d[i * dim + j] > 0.)
+      {
+        oldg = grid_tot_j / d[i * dim + j];
+        weight[i] = pow (((oldg - 1.) / oldg / log (oldg)), alpha);	// damped
+      }
+      tot_weight += weight[i];
+    }
+
+    double pts_per_bin = tot_weight / bins;
+    double xold;
+    double xnew = 0.;
+    double dw = 0.;
+    int i = 1;
+    for (int k = 0; k < bins; k++)
+    {
+      dw += weight[k];
+      xold = xnew;
+      xnew = xi[(k + 1) * dim + j];
+      for (; dw > pts_per_bin; i++)
+      {
+        dw -= pts_per_bin;
+        xin[i] = xnew - (xnew - xold) * dw / weight[k];
+      }
+    }
+    for (int k = 1; k < bins; k++)
+    {
+      xi[k * dim + j] = xin[k];
+    }
+    xi[bins * dim + j] = 1.;
+  }
+}
+
+//********************************************************************
+// The points of boxes first_box..last_box-1: adds the integral and the
+//  sum of variances of the boxes to *intgrl and *tss, and the grid
+//  distribution to d_chunk[]
+void
+VegasIntegrator::sample_chunk (const mc_batch_function &func,
+                               const double xl[], size_t first_box,
+                               size_t last_box, unsigned long int chunk_seed,
+                               double *intgrl, double *tss, double d_chunk[])
+{
+  BulkRng rng (chunk_seed);
+  size_t boxes_per_block = block_size / calls_per_box;
+  boxes_per_block = (boxes_per_block < 1 ? 1 : boxes_per_block);
+  size_t max_points = boxes_per_block * calls_per_box;
+  std::vector<double> x (dim * max_points);
+  std::vector<double> values (max_points);
+  std::vector<double> bin_vol (max_points);
+  std::vector<int> bin (dim * max_points);
+  std::vector<int> box_coord (dim * boxes_per_block);
+  const double scale = double (bins) / double (boxes);
+  const size_t cpb = calls_per_box;
+
+  for (size_t b0 = first_box; b0 < last_box; b0 += boxes_per_block)
+  {
+    size_t nb = (last_box - b0 < boxes_per_block ? last_box - b0
+                 : boxes_per_block);
+    size_t n = nb * cpb;
+    for (size_t bb = 0; bb < nb; bb++)
+    {				// digits of the box number, base boxes
+      size_t index = b0 + bb;
+      for (size_t j = 0; j < dim; j++)
+      {
+        box_coord[bb * dim + j] = int (index % boxes);
+        index /= boxes;
+      }
+    }
+
+    // the points, uniform in [0,1) first, then through the grid
+    rng.uniform (&x[0], long (dim * n));
+    for (size_t p = 0; p < n; p++)
+    {
+      bin_vol[p] = 1.;
+    }
+    for (size_t j = 0; j < dim; j++)
+    {
+      double *x_j = &x[j * n];
+      int *bin_j = &bin[j * n];
+      for (size_t bb = 0; bb < nb; bb++)
+      {
+        double box_j = box_coord[bb * dim + j];
+        for (size_t p = bb * cpb; p < (bb + 1) * cpb; p++)
+        {
+          double z = (box_j + x_j[p]) * scale;
+          int k = int (z);
+          k = (k < bins ? k : bins - 1);	// box_j + u can round up
+          double lower = xi[k * dim + j];
+          double width = xi[(k + 1) * dim + j] - lower;
+          x_j[p] = xl[j] + (lower + (z - k) * width) * delx[j];
+          bin_j[p] = k;
+          bin_vol[p] *= width;
+        }
+      }
+    }
+
+    func.f (&x[0], dim, n, func.params, &values[0]);
+
+    for (size_t bb = 0; bb < nb; bb++)
+    {
+      double m = 0.;
+      double q = 0.;
+      for (size_t k = 0; k < cpb; k++)
+      {
+        size_t p = bb * cpb + k;
+        double fval = jac * bin_vol[p] * values[p];
+        double delta = fval - m;	// mean and variance as in GSL
+        m += delta / (k + 1.);
+        q += delta * delta * (k / (k + 1.));
+        if (!stratified)
+        {
+          for (size_t j = 0; j < dim; j++)
+          {
+            d_chunk[bin[j * n + p] * dim + j] += fval * fval;
+          }
+        }
+      }
+      *intgrl += m * cpb;
+      double f_sq_sum = q * cpb;
+      *tss += f_sq_sum;
+      if (stratified)
+      {				// all points of the box are in the same bins
+        size_t p = (bb + 1) * cpb - 1;
+        for (size_t j = 0; j < dim; j++)
+        {
+          d_chunk[bin[j * n + p] * dim + j] += f_sq_sum;
+        }
+      }
+    }
+  }
+}
+
+//********************************************************************
+// iterations iterations of (about) calls points each; result and abserr
+//  are the weighted average of the iterations and its error
+void
+VegasIntegrator::integrate (const mc_batch_function &func, const double xl[],
+                            const double xu[], size_t calls, double *result,
+                            double *abserr)
+{
+  if (!grid_ready)
+  {
+    init_grid (xl, xu);
+    grid_ready = true;
+  }
+  sum_wgts = wtd_int_sum = chisq = 0.;
+  samples = 0;
+
+  // boxes and bins, as in gsl_monte_vegas_integrate
+  int new_bins = bins_max;
+  boxes = int (floor (pow (calls / 2., 1. / dim)));
+  boxes = (boxes < 1 ? 1 : boxes);
+  stratified = false;
+  if (2 * boxes >= bins_max)
+  {
+    int box_per_bin = (boxes / bins_max > 1 ? boxes / bins_max : 1);
+    new_bins = (boxes / box_per_bin < bins_max ? boxes / box_per_bin
+                : bins_max);
+    boxes = box_per_bin * new_bins;
+    stratified = true;
+  }
+  size_t tot_boxes = size_t (pow (double (boxes), double (dim)) + 0.5);
+  calls_per_box = (calls / tot_boxes > 2 ? calls / tot_boxes : 2);
+  calls = calls_per_box * tot_boxes;
+  jac = vol * pow (double (new_bins), double (dim)) / calls;
+  if (new_bins != bins)
+  {
+    resize_grid (new_bins);
+  }
+
+  // chunks of whole boxes with at least chunk_points points
+  size_t num_chunks = calls / chunk_points;
+  num_chunks = (num_chunks < 1 ? 1 : num_chunks);
+  num_chunks = (num_chunks > tot_boxes ? tot_boxes : num_chunks);
+  std::vector<double> chunk_int (num_chunks);
+  std::vector<double> chunk_tss (num_chunks);
+  std::vector<double> chunk_d (num_chunks * bins * dim);
+  unsigned long long key = mix64 (seed);
+
+  double cum_int = 0.;
+  double cum_sig = 0.;
+  for (int it = 0; it < iterations; it++)
+  {
+    chunk_int.assign (num_chunks, 0.);
+    chunk_tss.assign (num_chunks, 0.);
+    chunk_d.assign (num_chunks * bins * dim, 0.);
+    long c;
+#ifdef _OPENMP
+    int num_threads = (threads > 0 ? threads : omp_get_max_threads ());
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+#endif
+    for (c = 0; c < long (num_chunks); c++)
+    {
+      unsigned long int chunk_seed = (unsigned long int)
+        mix64 (key + ((unsigned long long) iteration_count << 24 | c)
+               * 0x9e3779b97f4a7c15ULL);
+      sample_chunk (func, xl, c * tot_boxes / num_chunks,
+                    (c + 1) * tot_boxes / num_chunks, chunk_seed,
+                    &chunk_int[c], &chunk_tss[c], &chunk_d[c * bins * dim]);
+    }
+    iteration_count++;
+
+    // add up the chunks in order, so the threads do not matter
+    double intgrl = 0.;
+    double tss = 0.;
+    for (size_t k = 0; k < size_t (bins) * dim; k++)
+    {
+      d[k] = 0.;
+    }
+    for (c = 0; c < long (num_chunks); c++)
+    {
+      intgrl += chunk_int[c];
+      tss += chunk_tss[c];
+      for (size_t k = 0; k < size_t (bins) * dim; k++)
+      {
+        d[k] += chunk_d[c * bins * dim + k];
+      }
+    }
+
+    // weight of this iteration, cumulative estimate, chi^2 (as in GSL)
+    double var = tss / (calls_per_box - 1.);
+    double wgt = 0.;
+    if (var > 0.)
+    {
+      wgt = 1. / var;
+    }
+    else if (sum_wgts > 0.)
+    {
+      wgt = sum_wgts / samples;
+    }
+    iteration_result = intgrl;
+    iteration_sigma = sqrt (var);
+
+    if (wgt > 0.)
+    {
+      double m = (sum_wgts > 0. ? wtd_int_sum / sum_wgts : 0.);
+      double q = intgrl - m;
+      double old_sum_wgts = sum_wgts;
+      samples++;
+      sum_wgts += wgt;
+      wtd_int_sum += intgrl * wgt;
+      cum_int = wtd_int_sum / sum_wgts;
+      cum_sig = sqrt (1. / sum_wgts);
+      if (samples == 1)
+      {
+        chisq = 0.;
+      }
+      else
+      {
+        chisq *= (samples - 2.);
+        chisq += (wgt / (1. + (wgt / old_sum_wgts))) * q * q;
+        chisq /= (samples - 1.);
+      }
+    }
+    else
+    {
+      cum_int += (intgrl - cum_int) / (it + 1.);
+      cum_sig = 0.;
+    }
+
+    refine_grid ();
+  }
+
+  *result = cum_int;
+  *abserr = cum_sig;
+}
@@ -0,0 +1,92 @@
+//  file: VegasIntegrator.h
+//
+//  Header file for VegasIntegrator class: adaptive Monte Carlo
+//   integration by the VEGAS algorithm (Lepage), with the samples of
+//   each iteration spread over OpenMP threads
+//
+//  Revision history:
+//      06/03/21  original version
+//      06/07/21  is_stratified()
+//
+//  Notes:
+//   * the algorithm is the one of gsl_monte_vegas (same grid refinement,
+//      boxes for stratified sampling, weighting of the iterations and
+//      chi^2), so results and error estimates agree with GSL within the
+//      statistics, but the integrand is an mc_batch_function that gets a
+//      block of points at a time.
+//   * as with GSL, integrate() does `iterations' iterations of `calls'
+//      points each.  The first call sets up the grid; later calls keep
+//      the refined grid but start new cumulative estimates (like a GSL
+//      state at stage 1).
+//   * the boxes of an iteration are split into chunks of at least
+//      chunk_points points.  Each chunk has its own BulkRng, seeded from
+//      the seed, the iteration number and the chunk number, and its own
+//      sums, which are added up in chunk order.  So the result depends
+//      only on the seed, not on the number of threads.
+//
+#ifndef VEGAS_INTEGRATOR_H
+#define VEGAS_INTEGRATOR_H
+
+#include <vector>
+#include <cstddef>
+
+#include "MCBatchIntegrator.h"	// mc_batch_function
+
+class VegasIntegrator
+{
+public:
+  VegasIntegrator (size_t dim, unsigned long int seed);
+
+  // integral of func over the box xl[k] < x[k] < xu[k]
+  void integrate (const mc_batch_function &func, const double xl[],
+                  const double xu[], size_t calls, double *result,
+                  double *abserr);
+
+  void set_iterations (int num) { iterations = num; };
+  void set_alpha (double alpha_in) { alpha = alpha_in; };	// grid stiffness
+  void set_threads (int num_threads) { threads = num_threads; };	// 0 = all
+
+  double get_chisq () { return chisq; };	// per degree of freedom
+  double get_iteration_result () { return iteration_result; };	// last one
+  double get_iteration_sigma () { return iteration_sigma; };
+  bool is_stratified () { return stratified; };	// in the last call
+
+  static const int bins_max = 50;	// grid bins per coordinate
+  static const size_t chunk_points = 8192;	// points per rng stream
+  static const size_t block_size = 1024;	// points per call of func.f
+
+private:
+  void init_grid (const double xl[], const double xu[]);
+  void resize_grid (int new_bins);
+  void refine_grid ();
+  void sample_chunk (const mc_batch_function &func, const double xl[],
+                     size_t first_box, size_t last_box,
+                     unsigned long int chunk_seed, double *intgrl,
+                     double *tss, double d_chunk[]);
+
+  size_t dim;
+  unsigned long int seed;
+  int threads;
+  int iterations;		// per call of integrate()
+  double alpha;
+  long iteration_count;		// all iterations so far (for the seeds)
+
+  bool stratified;		// one box per grid bin, or more
+  int bins;			// grid bins per coordinate
+  int boxes;			// boxes per coordinate
+  size_t calls_per_box;
+  double jac;			// volume * bins^dim / calls
+  double vol;			// volume of the integration region
+  std::vector<double> delx;	// xu - xl
+  std::vector<double> xi;	// grid: xi[k*dim + j], k = 0..bins, in [0,1]
+  std::vector<double> xin;	// new grid of one coordinate
+  std::vector<double> d;	// distribution: d[k*dim + j], k < bins
+  std::vector<double> weight;	// of the bins of one coordinate
+  bool grid_ready;
+
+  double sum_wgts, wtd_int_sum, chisq;
+  int samples;
+  double iteration_result, iteration_sigma;
+};
+
+#endif
@@ -9,14 +9,15 @@
 //      20-Feb-2004  original version, converted gaussian_random.c
 //      19-Feb-2005  minor changes to variable names and comments
 //      13-Feb-2006  tidied up the code, moved declarations
+//      06-Jun-2021  rng from RngStreams (seed 0: RNG_SEED or /dev/urandom)
 //
 //  Notes:
 //   * uses the GSL random number functions
 //   * both the gsl_rng.h and gsl_randist.h header files are needed
-//   * the current version uses the gsl_rng_taus random number
-//      generator.  There are many other choices (just change
-//      the name in the gsl_rng_alloc statement).  See the GSL
-//      manual for a list of generators and their properties.
+//   * the generator comes from RngStreams::thread_rng(), seeded from
+//      the master seed, which is printed so a run can be repeated.
+//      RngStreams::new_rng takes any other GSL generator type.  See the
+//      GSL manual for a list of generators and their properties.
 //   * The Gaussian random variate has mean zero and standard deviation
 //      sigma.  Its probability distribution is
 //        p(x)dx = 1/Sqrt[2 Pi sigma^2] Exp[-x^2/(2 sigma^2)]
@@ -32,18 +33,19 @@ using namespace std;		// we need this when .h is omitted
 #include <gsl/gsl_rng.h>	// GSL random number generators
 #include <gsl/gsl_randist.h>	// GSL random distributions
 
+#include "RngStreams.h"	// seeds and streams for the GSL generators
 
 //********************************************************************
 int
 main ()
 {
   gsl_rng *rng_ptr;		// pointer to random number generator (rng) 
-  rng_ptr = gsl_rng_alloc (gsl_rng_taus);	// allocate the rng 
 
   unsigned long int seed;	// "seed" for the random number generators
-  cout << "Enter a long integer as a seed: ";
+  cout << "Enter a long integer as a seed or 0 to generate one: ";
   cin >> seed;
-  gsl_rng_set (rng_ptr, seed);	// seed the rng 
+  RngStreams::init (seed);	// 0: from RNG_SEED or /dev/urandom
+  rng_ptr = RngStreams::thread_rng ();	// seeded from the master seed
 
   // output file for numbers
   ofstream out;
@@ -74,7 +76,6 @@ main ()
 	  << gaussian1 << " " << gaussian2 << endl;
     }
 
-  gsl_rng_free (rng_ptr);	// free the random number generator
   cout << "Output " << npts << " random numbers to random_numbers.dat." << endl; 
   out.close ();			// close the output file
 
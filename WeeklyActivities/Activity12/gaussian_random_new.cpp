@@ -12,17 +12,37 @@
 //      06-Mar-2004  added histrogramming and commented out output
 //      19-Feb-2005  minor changes to variable names and comments
 //      13-Feb-2006  tidied up the code, moved declarations
+//      01-Jun-2021  rng from RngStreams (seed 0: RNG_SEED or /dev/urandom)
+//      04-Jun-2021  numbers from BulkRng a chunk at a time (Ziggurat and
+//                    Box-Muller gaussians, exponentials), binned with
+//                    Histogram on OpenMP threads; histogram_bin removed
+//      05-Jun-2021  HistogramShards for the threads; 2D histogram of
+//                    successive gaussian pairs
 //
 //  Notes:
-//   * uses the GSL random number functions
-//   * both the gsl_rng.h and gsl_randist.h header files are needed
-//   * the current version uses the gsl_rng_taus random number
-//      generator.  There are many other choices (just change
-//      the name in the gsl_rng_alloc statement).  See the GSL
-//      manual for a list of generators and their properties.
+//   * the numbers used to come one at a time from gsl_ran_flat and
+//      gsl_ran_gaussian, each binned with a divide.  Now BulkRng fills
+//      arrays of chunk_size numbers and Histogram bins them, so 10^9
+//      numbers take seconds instead of minutes.
+//   * chunk c has its own BulkRng, seeded with RngStreams stream c, and
+//      each OpenMP thread fills its own copy of the histograms
+//      (HistogramShards), merged at the end.  The counts depend only on
+//      the seed, not on the number of threads.
+//   * the pairs (gaussian1[2k], gaussian1[2k+1]) of Ziggurat numbers are
+//      binned in 2D, which shows up any correlation between successive
+//      numbers; the counts go to random_histogram2d.bin (see the notes
+//      in Histogram.h for the format).
+//   * gaussian1 is from the Ziggurat method and gaussian2 from the
+//      Box-Muller transformation (see BulkRng.h), so the two histograms
+//      compare the methods.  The exponential numbers have mean mu and
+//      p(x)dx = 1/mu Exp[-x/mu] dx.
 //   * The Gaussian random variate has mean zero and standard deviation
 //      sigma.  Its probability distribution is
 //        p(x)dx = 1/Sqrt[2 Pi sigma^2] Exp[-x^2/(2 sigma^2)]
+//   * values outside the histogram range are counted as under/overflow
+//      (before, a gaussian beyond 3 sigma was put in a bin off the end of
+//      the array).
+//   * compile with make -f make_gaussian_random_new (needs -fopenmp)
 //
 //******************************************************************
 
@@ -30,111 +50,149 @@
 #include <iostream>		// cout and cin
 #include <iomanip>		// manipulators like setprecision
 #include <fstream>		// file input and output
+#include <vector>
+#include <ctime>
 using namespace std;		// we need this when .h is omitted
 
-#include <gsl/gsl_rng.h>	// GSL random number generators
-#include <gsl/gsl_randist.h>	// GSL random distributions
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "RngStreams.h"	// seeds and streams for the generators
+#include "BulkRng.h"		// arrays of random numbers
+#include "Histogram.h"
 
 // function prototypes
-extern unsigned long int random_seed ();	// routine to generate a seed
-int histogram_bin (const double value, const int num_bins, 
-  const double bin_min, const double bin_max);  // routine to find bins
-void histogram_x (double x_bins[], const int num_bins, 
-  const double bin_min, const double bin_max);  // find x values of bins
+double wall_time ();
 
 //********************************************************************
 int
 main ()
 {
-  gsl_rng *rng_ptr;		// pointer to random number generator (rng) 
-  rng_ptr = gsl_rng_alloc (gsl_rng_taus);	// allocate the rng 
-
   unsigned long int seed;	// "seed" for the random number generators
   cout << "Enter a long integer as a seed or 0 to generate one: ";
   cin >> seed;
-  if (seed == 0)
-    {				// generate a seed from /dev/random
-      seed = random_seed ();
-    }
+  RngStreams::init (seed);	// 0: from RNG_SEED or /dev/urandom
 
-  cout << " Using " << seed << " to seed the RNG" << endl;
-  gsl_rng_set (rng_ptr, seed);	// seed the rng 
+  // generate uniform, gaussian and exponential distributed random numbers
 
-  // output file for numbers [commented out]
-  // ofstream out;
-  // out.open ("random_numbers.dat");
-
-  // generate uniform and gaussian distributed random numbers
-
-  int npts = 100;		// number of random numbers to generate 
+  long npts = 100;		// number of random numbers to generate 
   cout << "How many random numbers? ";
   cin >> npts;
 
   double lower = 0.;		// lower limit for uniform region
   double upper = 1.;		// upper limit for uniform region
   double sigma = 1.;		// standard deviation of gaussian distribution 
+  double mu = 1.;		// mean of exponential distribution
 
   // set up histogram bins
   const int num_bins = 50;
-  int my_bin = 0;
-  int uniform1_bins[num_bins] = {0};
-  int uniform2_bins[num_bins] = {0};
-  double uniform_x[num_bins] = {0.};
-  histogram_x(uniform_x,num_bins,lower,upper);
-  
-  int gaussian1_bins[num_bins] = {0};
-  int gaussian2_bins[num_bins] = {0};
-  double gaussian_min = -3.*sigma;
-  double gaussian_max = 3.*sigma;
-  double gaussian_x[num_bins] = {0.};
-  histogram_x(gaussian_x,num_bins,gaussian_min,gaussian_max);
-
-  // out << "# uniform1 uniform2 gaussian1 gaussian2" << endl;
-  for (int i = 0; i < npts; i++)
+  Histogram uniform1_hist (num_bins, lower, upper);
+  Histogram uniform2_hist (num_bins, lower, upper);
+  Histogram gaussian1_hist (num_bins, -3.*sigma, 3.*sigma);
+  Histogram gaussian2_hist (num_bins, -3.*sigma, 3.*sigma);
+  Histogram exponential_hist (num_bins, 0., 6.*mu);
+  HistogramAxis pair_axis (num_bins, -3.*sigma, 3.*sigma);
+  Histogram2D pairs_hist (pair_axis, pair_axis);
+
+  // a copy of each for every thread
+  HistogramShards<Histogram> uniform1_shards (uniform1_hist);
+  HistogramShards<Histogram> uniform2_shards (uniform2_hist);
+  HistogramShards<Histogram> gaussian1_shards (gaussian1_hist);
+  HistogramShards<Histogram> gaussian2_shards (gaussian2_hist);
+  HistogramShards<Histogram> exponential_shards (exponential_hist);
+  HistogramShards<Histogram2D> pairs_shards (pairs_hist);
+
+  const long chunk_size = 1 << 16;	// numbers of each kind per chunk
+  long num_chunks = (npts + chunk_size - 1) / chunk_size;
+  int num_threads = 1;
+#ifdef _OPENMP
+  num_threads = omp_get_max_threads ();
+#endif
+
+  double start = wall_time ();
+#pragma omp parallel
+  {
+    vector<double> values (chunk_size);
+    vector<double> even (chunk_size / 2), odd (chunk_size / 2);
+    Histogram &my_uniform1 = uniform1_shards.local ();	// this thread's
+    Histogram &my_uniform2 = uniform2_shards.local ();
+    Histogram &my_gaussian1 = gaussian1_shards.local ();
+    Histogram &my_gaussian2 = gaussian2_shards.local ();
+    Histogram &my_exponential = exponential_shards.local ();
+    Histogram2D &my_pairs = pairs_shards.local ();
+
+#pragma omp for schedule(static)
+    for (long c = 0; c < num_chunks; c++)
     {
-      // uniform random numbers from [lower,upper]
-      double uniform1 = gsl_ran_flat (rng_ptr, lower, upper);
-      my_bin = histogram_bin(uniform1,num_bins,lower,upper);
-      uniform1_bins[my_bin]++;
-      
-      double uniform2 = gsl_ran_flat (rng_ptr, lower, upper);
-      my_bin = histogram_bin(uniform2,num_bins,lower,upper);
-      uniform2_bins[my_bin]++;
+      BulkRng rng (RngStreams::stream_seed (c));
+      long n = (npts - c * chunk_size < chunk_size ? npts - c * chunk_size
+                : chunk_size);
 
-      // random numbers distributed as gaussians
-      double gaussian1 = gsl_ran_gaussian (rng_ptr, sigma);
-      my_bin = histogram_bin(gaussian1,num_bins,gaussian_min,gaussian_max);
-      gaussian1_bins[my_bin]++;
-
-      double gaussian2 = gsl_ran_gaussian (rng_ptr, sigma);
-      my_bin = histogram_bin(gaussian2,num_bins,gaussian_min,gaussian_max);
-      gaussian2_bins[my_bin]++;
+      // uniform random numbers from [lower,upper)
+      rng.uniform (&values[0], n, lower, upper);
+      my_uniform1.add (&values[0], n);
+      rng.uniform (&values[0], n, lower, upper);
+      my_uniform2.add (&values[0], n);
 
-      //  out << "  " << fixed << uniform1 << " " << uniform2 << " "
-      //	<< gaussian1 << " " << gaussian2 << endl;
+      // random numbers distributed as gaussians
+      rng.ziggurat_gaussian (&values[0], n, sigma);
+      my_gaussian1.add (&values[0], n);
+      for (long k = 0; k < n / 2; k++)
+      {
+        even[k] = values[2*k];
+        odd[k] = values[2*k + 1];
+      }
+      my_pairs.add (&even[0], &odd[0], n / 2);
+
+      rng.gaussian (&values[0], n, sigma);
+      my_gaussian2.add (&values[0], n);
+
+      // and as an exponential
+      rng.exponential (&values[0], n, mu);
+      my_exponential.add (&values[0], n);
     }
+  }
+  uniform1_shards.merge_into (uniform1_hist);
+  uniform2_shards.merge_into (uniform2_hist);
+  gaussian1_shards.merge_into (gaussian1_hist);
+  gaussian2_shards.merge_into (gaussian2_hist);
+  exponential_shards.merge_into (exponential_hist);
+  pairs_shards.merge_into (pairs_hist);
+  double elapsed = wall_time () - start;
 
-  gsl_rng_free (rng_ptr);	// free the random number generator 
-  // out.close ();			// close the output file
-   
   ofstream hist;
   hist.open ("random_histogram.dat");
 
   hist << "# bin x_uniform uniform1 uniform2 x_gaussian gaussian1 gaussian2 "
-       << endl;
+       << "x_exponential exponential" << endl;
   for (int i = 0; i < num_bins; i++)
   {
     hist << "  " << setw(3) << i+1 << "    " 
-         << setw(5) << uniform_x[i] << " "
-         << setw(7) << uniform1_bins[i] << " "
-         << setw(7) << uniform2_bins[i] << "     "
-         << setw(5) << gaussian_x[i] << "   "
-         << setw(7) << gaussian1_bins[i] << " "
-         << setw(7) << gaussian2_bins[i] << endl;  
+         << setw(5) << uniform1_hist.x (i) << " "
+         << setw(7) << uniform1_hist.count (i) << " "
+         << setw(7) << uniform2_hist.count (i) << "     "
+         << setw(5) << gaussian1_hist.x (i) << "   "
+         << setw(7) << gaussian1_hist.count (i) << " "
+         << setw(7) << gaussian2_hist.count (i) << "     "
+         << setw(5) << exponential_hist.x (i) << "   "
+         << setw(7) << exponential_hist.count (i) << endl;  
   }
 
   cout << "Histogrammed " << npts 
-       << " random numbers in random_histogram.dat." << endl; 
+       << " random numbers of each kind in random_histogram.dat." << endl; 
+  if (pairs_hist.write_binary ("random_histogram2d.bin"))
+  {
+    cout << "Gaussian pairs histogrammed in random_histogram2d.bin." << endl;
+  }
+  cout << "outside the gaussian histograms: "
+       << gaussian1_hist.underflow () + gaussian1_hist.overflow ()
+       << " (Ziggurat) and "
+       << gaussian2_hist.underflow () + gaussian2_hist.overflow ()
+       << " (Box-Muller)" << endl;
+  cout << setprecision (3) << elapsed << " s on " << num_threads
+       << " threads (" << 1.e9 * elapsed / (5. * double (npts))
+       << " ns per number)" << endl;
        
   hist.close ();                // close the histogram file
 
@@ -143,46 +201,14 @@ main ()
 
 
 //*********************************************************************
-//
-//  histogram_bin returns an integer from 0 to num_bins-1, which is the
-//   bin number that value falls into.
-//  histogram_x returns an array of the values of the bins
-//
-//   value --- number whose bin we're identifying
-//   num_bins --- total number of bins
-//   bin_min --- least value
-//   bin_max --- greatest value
-//
-//  Revision history:
-//   06-Mar-2004  original version 
-//
-//**********************************************************************   
-int
-histogram_bin (const double value, const int num_bins, 
-  const double bin_min, const double bin_max)
-{
-  int bin_number = 0;
-    
-  if (value < bin_min) {
-    bin_number = 0;
-  } else if (value > bin_max) {
-    bin_number = num_bins-1;
-  }
-  
-  // bin_number is fraction of interval * number of bins
-  bin_number = int(double(num_bins)*(value - bin_min)/(bin_max - bin_min));
-    
-  return bin_number;
-}
 
-void
-histogram_x (double x_bins[], const int num_bins, 
-  const double bin_min, const double bin_max)
+// wall-clock time in seconds
+double
+wall_time ()
 {
-  double delta_x = (bin_max-bin_min)/(double(num_bins));
-  
-  for (int i=0; i < num_bins; i++)
-  {
-    x_bins[i] = bin_min + (double(i)+0.5)*delta_x;
-  } 
+#ifdef _OPENMP
+  return omp_get_wtime ();
+#else
+  return double (clock ()) / CLOCKS_PER_SEC;
+#endif
 }
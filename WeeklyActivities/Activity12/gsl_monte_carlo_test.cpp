@@ -6,11 +6,21 @@
 //
 //  Revision history:
 //      02/19/05  original version, based on Monte_Carlo_test.cpp
+//      06/01/21  rng from RngStreams, which prints the master seed
+//      06/03/21  pointer to the native integrators
+//      06/07/21  side by side with the native integrators, and a 2-D
+//                 peaked gaussian
 //
 //  Notes:  
 //   * For more details, see the GNU Scientific Library Reference Manual
-//   * Compile and link with:
-//  g++ -Wall -o gsl_monte_carlo_test gsl_monte_carlo_test.cpp -lgsl -lgslcblas
+//   * vegas_miser_test.cpp does the same integrals with MiserIntegrator
+//      and VegasIntegrator (batched integrand, OpenMP threads).  The
+//      last part here runs both with the same calls, for the 10-D
+//      integral and for a normalized gaussian of width 0.1 in 2-D
+//      (where vegas has many boxes per bin), and prints the results
+//      and sigmas side by side.
+//   * Compile and link with make -f make_gsl_monte_carlo_test (needs
+//      -fopenmp for the native integrators)
 //
 //*********************************************************************//
 
@@ -26,13 +36,26 @@ using namespace std;
 #include <gsl/gsl_monte_miser.h>
 #include <gsl/gsl_monte_vegas.h>
 
+#include "RngStreams.h"	// seeds and streams for the GSL generators
+#include "MCBatchIntegrator.h"
+#include "MiserIntegrator.h"
+#include "VegasIntegrator.h"
 
 // Function prototypes
-extern unsigned long int random_seed ();	// routine to generate a seed
 double my_integrand (double *x, size_t dim, void *params);
+void my_batch_integrand (const double *x, size_t dim, size_t n,
+                         void *params, double *values);
+double gaussian_integrand (double *x, size_t dim, void *params);
+void gaussian_batch_integrand (const double *x, size_t dim, size_t n,
+                               void *params, double *values);
 void display_results (const char *title, double result, double error);
+void compare_integrators (const char *title, gsl_monte_function &gsl_function,
+                          const mc_batch_function &batch_function,
+                          double xl[], double xu[], size_t calls,
+                          gsl_rng *rng_ptr, double exact_value);
 
 const double exact = 155./6.;
+const double gaussian_width = 0.1;
 
 //*********************************************************************//
 
@@ -49,9 +72,7 @@ main ()
   // set up the random number generator
   gsl_rng *rng_ptr;		// declare pointer to random number 
                                 //   generator (rng) 
-  rng_ptr = gsl_rng_alloc (gsl_rng_taus);	// allocate the rng 
-  unsigned long int seed = random_seed ();  // generate a random seed
-  gsl_rng_set (rng_ptr, seed);	// seed the rng 
+  rng_ptr = RngStreams::thread_rng ();	// seeded from the master seed
 
   // set up the function for Monte Carlo routines
   gsl_monte_function my_gsl_function = { &my_integrand, dimension, NULL };
@@ -102,6 +123,22 @@ main ()
 
   display_results ("vegas final", result, error);
 
+  // GSL and the native integrators side by side
+  mc_batch_function my_batch_function =
+    { &my_batch_integrand, dimension, NULL };
+  compare_integrators ("(x1 + ... + x10)^2", my_gsl_function,
+                       my_batch_function, xl, xu, calls, rng_ptr, exact);
+
+  const int dim2 = 2;
+  double xl2[dim2] = { 0., 0. };
+  double xu2[dim2] = { 1., 1. };
+  gsl_monte_function gaussian_gsl = { &gaussian_integrand, dim2, NULL };
+  mc_batch_function gaussian_batch =
+    { &gaussian_batch_integrand, dim2, NULL };
+  double erf_half = erf (0.5 / (gaussian_width * sqrt (2.)));
+  compare_integrators ("2-D gaussian", gaussian_gsl, gaussian_batch,
+                       xl2, xu2, calls, rng_ptr, erf_half * erf_half);
+
   return 0;
 }
 
@@ -120,6 +157,58 @@ my_integrand (double *x, size_t dim, void *)
   return sum*sum;
 }
 
+// the same integrand, for a block of n points (x[k*n + i])
+void
+my_batch_integrand (const double *x, size_t dim, size_t n, void *,
+                    double *values)
+{
+  for (size_t i = 0; i < n; i++)
+    {
+      values[i] = 0.;
+    }
+  for (size_t k = 0; k < dim; k++)
+    {
+      for (size_t i = 0; i < n; i++)
+        {
+          values[i] += x[k*n + i];
+        }
+    }
+  for (size_t i = 0; i < n; i++)
+    {
+      values[i] = values[i]*values[i];
+    }
+}
+
+// normalized gaussian of width gaussian_width centered at (1/2, 1/2, ...)
+double
+gaussian_integrand (double *x, size_t dim, void *)
+{
+  double a = 1. / (2. * gaussian_width * gaussian_width);
+  double r2 = 0.;
+
+  for (int i = 0; i < int(dim); i++)
+    {
+      r2 += (x[i] - 0.5) * (x[i] - 0.5);
+    }
+
+  return pow (a / M_PI, 0.5 * double (dim)) * exp (-a * r2);
+}
+
+void
+gaussian_batch_integrand (const double *x, size_t dim, size_t n, void *,
+                          double *values)
+{
+  double point[2];		// dim is 2 here
+  for (size_t i = 0; i < n; i++)
+    {
+      for (size_t k = 0; k < dim; k++)
+        {
+          point[k] = x[k*n + i];
+        }
+      values[i] = gaussian_integrand (point, dim, NULL);
+    }
+}
+
 //*********************************************************************//
 
 void
@@ -136,3 +225,68 @@ display_results (const char *title, double result, double error)
     << " = " << setprecision (1) << setw (2)
     << fabs (result - exact) / error << " sigma " << endl << endl;
 }
+
+//*********************************************************************//
+
+// plain, miser and vegas (10000 warm-up, then 2 x calls/2) from GSL and
+//  from the native integrators, with the same numbers of calls
+void
+compare_integrators (const char *title, gsl_monte_function &gsl_function,
+                     const mc_batch_function &batch_function, double xl[],
+                     double xu[], size_t calls, gsl_rng *rng_ptr,
+                     double exact_value)
+{
+  size_t dim = gsl_function.dim;
+  double gsl_result[3], gsl_error[3], native_result[3], native_error[3];
+
+  gsl_monte_plain_state *plain_state = gsl_monte_plain_alloc (dim);
+  gsl_monte_plain_integrate (&gsl_function, xl, xu, dim, calls, rng_ptr,
+                             plain_state, &gsl_result[0], &gsl_error[0]);
+  gsl_monte_plain_free (plain_state);
+  MCBatchIntegrator plain (dim,
+                      RngStreams::stream_seed (RngStreams::next_stream ()));
+  MCAccumulator plain_acc;
+  plain.sample_uniform (batch_function, xl[0], xu[0], calls, plain_acc);
+  native_result[0] = plain_acc.mean ();
+  native_error[0] = plain_acc.naive_error ();
+
+  gsl_monte_miser_state *miser_state = gsl_monte_miser_alloc (dim);
+  gsl_monte_miser_integrate (&gsl_function, xl, xu, dim, calls, rng_ptr,
+                             miser_state, &gsl_result[1], &gsl_error[1]);
+  gsl_monte_miser_free (miser_state);
+  MiserIntegrator miser (dim,
+                      RngStreams::stream_seed (RngStreams::next_stream ()));
+  miser.integrate (batch_function, xl, xu, calls, &native_result[1],
+                   &native_error[1]);
+
+  gsl_monte_vegas_state *vegas_state = gsl_monte_vegas_alloc (dim);
+  VegasIntegrator vegas (dim,
+                      RngStreams::stream_seed (RngStreams::next_stream ()));
+  gsl_monte_vegas_integrate (&gsl_function, xl, xu, dim, 10000, rng_ptr,
+                             vegas_state, &gsl_result[2], &gsl_error[2]);
+  vegas.integrate (batch_function, xl, xu, 10000, &native_result[2],
+                   &native_error[2]);
+  for (int i=0; i < 2; i++)
+    {
+      gsl_monte_vegas_integrate (&gsl_function, xl, xu, dim, calls / 2,
+                                 rng_ptr, vegas_state, &gsl_result[2],
+                                 &gsl_error[2]);
+      vegas.integrate (batch_function, xl, xu, calls / 2,
+                       &native_result[2], &native_error[2]);
+    }
+  gsl_monte_vegas_free (vegas_state);
+
+  const char *name[3] = { "plain", "miser", "vegas" };
+  cout << endl << title << ", exact = " << fixed << setprecision (6)
+       << exact_value << (vegas.is_stratified () ? " (vegas stratified)"
+                          : "") << endl;
+  cout << "         GSL result     sigma    native result     sigma"
+       << endl;
+  for (int m = 0; m < 3; m++)
+    {
+      cout << name[m] << "  " << setw (13) << gsl_result[m] << " "
+           << setw (10) << gsl_error[m] << "  " << setw (13)
+           << native_result[m] << " " << setw (10) << native_error[m]
+           << endl;
+    }
+}
@@ -7,13 +7,35 @@
 //  Revision history:
 //      06-Mar-2004  original version (from mc_integration.c)
 //      25-Feb-2012  switched functions and eliminated trials
+//      27-May-2021  statistical error of the estimate from an MCAccumulator
+//      01-Jun-2021  rng from RngStreams, which prints the master seed
+//      02-Jun-2021  integrand evaluated a block of points at a time by
+//                    an MCBatchIntegrator, with the points from a BulkRng
+//      03-Jun-2021  one running MCAccumulator for all Nvec (each
+//                    checkpoint adds only the new points), stop at a
+//                    target relative error
+//      07-Jun-2021  speed measured against the original version
 //
 //  Notes:
 //   * random numbers are generated uniformly from lower to upper
-//   * uses the GSL random number functions
-//   * both the gsl_rng.h and gsl_randist.h header files are needed
-//   * the current version uses the gsl_rng_taus random number
-//      generator.  There are many other choices (see the GSL manual).
+//   * the points come in blocks from MCBatchIntegrator (xoshiro256+
+//      generators seeded from RngStreams) instead of one coordinate at
+//      a time from gsl_ran_flat, and integrand1 does the sums for a
+//      whole block, with the normalization (2 pi sigma^2)^(-dim/2)
+//      computed once instead of pow() for every point.  At dim = 10,
+//      compiled with -O3 -ffast-math, a point takes about 17 ns against
+//      about 47 ns with gsl_ran_flat and taus, 2.7 times faster; with
+//      ARCHFLAGS=-march=native (AVX-512) about 8 ns, 6 times faster.
+//      (Adding the values to the MCAccumulator one at a time with
+//      add(), as at first, cost another 6 ns per point.)
+//   * Nvec still doubles from one line of output to the next, but the
+//      samples of the earlier lines are kept, so getting to Nvec costs
+//      Nvec points instead of 2*Nvec.  The run stops at the first
+//      checkpoint (after at least Nvec_stop points) where the estimated
+//      error is below target times the estimate, or at Nvec_max.
+//   * the points are independent, so the error is the naive one,
+//      sqrt(variance/Nvec), which fluctuates less than the blocking
+//      error() of the MCAccumulator.
 //
 //******************************************************************
 
@@ -24,16 +46,25 @@
 using namespace std;		// we need this when .h is omitted
 #include <cmath>
 
-#include <gsl/gsl_rng.h>	// GSL random number generators
-#include <gsl/gsl_randist.h>	// GSL random distributions
+#include <ctime>
+
+#include "RngStreams.h"	// seeds and streams for the random numbers
+#include "MCAccumulator.h"	// average with error bar
+#include "MCBatchIntegrator.h"	// blocks of points and integrand values
 
 // function prototypes
-extern unsigned long int random_seed ();	// routine to generate a seed
 inline double sqr (double x) {return (x*x);};  // to square x
 
-// integrand for uniform sampling
-double integrand1(gsl_rng *rng_ptr, int dim, double sigma, double lower, 
-                  double upper); 
+// parameters of the integrand
+struct integrand_params
+{
+  double sigma;                 // constant in gaussian
+  double norm;                  // 1/sqrt(2pi*sigma^2)^dim
+};
+
+// integrand for uniform sampling, at n points x[k*n + i]
+void integrand1(const double *x, size_t dim, size_t n, void *params,
+                double *values); 
 
 //********************************************************************
 int
@@ -45,67 +76,105 @@ main (void)
   const int dim = 10;                // dimension of the integral
   double exact = double(dim)*sqr(sigma);   // exact answer from Mathematica
 
-  int Nvec = 0;		        // number of vectors used to evaluate integral
-  int Nvec_min = 10;            // mininum # of vectors to use
-  int Nvec_max = 1000000;        // maximum # of vectors to us
-  unsigned long int seed;
-  gsl_rng *rng_ptr;		// declare pointer to random number 
-                                //   generator (rng) 
-  rng_ptr = gsl_rng_alloc (gsl_rng_taus);	// allocate the rng 
+  long Nvec = 0;		        // number of vectors used to evaluate integral
+  long Nvec_min = 10;           // first checkpoint
+  long Nvec_stop = 1000;        // mininum # of vectors before stopping
+  long Nvec_max = 100000000;    // maximum # of vectors to use
+  double target;                // target relative error
+  integrand_params params = { sigma, pow(1./sqrt(2.*M_PI*sqr(sigma)),dim) };
+  mc_batch_function func = { &integrand1, dim, &params };
+  MCBatchIntegrator integrator (dim,  // seeded from the master seed
+                      RngStreams::stream_seed (RngStreams::next_stream ()));
 
-  seed = random_seed ();    // generate a seed
-  cout << " Using " << seed << " to seed the RNG" << endl;
-  gsl_rng_set (rng_ptr, seed);	// seed the rng 
+  cout << "Target relative error (e.g. 0.01): ";
+  cin >> target;
 
   // output file mc_integration.dat has data on the average R 
   ofstream out;
   out.open ("mc_integration.dat");
 
-  cout << endl << "  Nvec   estimate  exact    rel. error " << endl;
+  cout << endl << "     Nvec   estimate  exact    rel. error   est. error"
+       << endl;
+  clock_t start = clock ();
+  MCAccumulator integrand_acc;	// samples of the integrand, all Nvec
+  double volume = pow((upper - lower),dim);
+  double integral_avg = 0.;
+  double integral_err = 0.;
   for (Nvec = Nvec_min; Nvec <= Nvec_max; Nvec *= 2)
   {
-    double integral_avg = 0;	// reset integral to zero 
-    for (int j = 0; j < Nvec; j++)
-    {
-       // sample integrand1 (uniform sampling)	
-       integral_avg += integrand1(rng_ptr,dim,sigma,lower,upper);  
-    }
-    integral_avg = pow((upper - lower),dim) * integral_avg / double(Nvec);
+    // sample integrand1 (uniform sampling) at the new points only
+    integrator.sample_uniform (func, lower, upper,
+                               Nvec - integrand_acc.count (), integrand_acc);
+    integral_avg = volume * integrand_acc.mean ();
+    integral_err = volume * integrand_acc.naive_error ();  // one sigma
     
-    cout << setw(6) << Nvec << "   " << fixed << setprecision(4) 
+    cout << setw(9) << Nvec << "   " << fixed << setprecision(4) 
          << setw(7) << integral_avg 
 	 << "   " << exact 
-	 << "   " << scientific << abs(integral_avg-exact)/exact << endl;
+	 << "   " << scientific << abs(integral_avg-exact)/exact
+	 << "   " << integral_err/exact << endl;
     out << Nvec << " " << fixed << setprecision(8) 
-        << integral_avg << " " << exact << endl;
+        << integral_avg << " " << exact << " " << integral_err << endl;
+    cout.unsetf (ios::floatfield);
+    out.unsetf (ios::floatfield);
+    if (Nvec >= Nvec_stop && integral_err <= target*abs(integral_avg))
+    {
+      break;                    // reached the target
+    }
   }
     
+  long total_points = integrand_acc.count ();
+  double seconds = double (clock () - start) / CLOCKS_PER_SEC;
+  if (integral_err > target*abs(integral_avg))
+  {
+    cout << endl << "target not reached by Nvec_max";
+  }
+  cout << endl << total_points << " points in " << fixed << setprecision(2)
+       << seconds << " s (" << setprecision(1)
+       << 1.e9 * seconds / double (total_points) << " ns per point)" << endl;
   cout << endl << "Data also output to mc_integration.dat." << endl;
 
-  gsl_rng_free (rng_ptr);	// free the random number generator 
   out.close ();			// close the output file
 
   return 0;
 }
 
 //********************************************************************
-double 
-integrand1(gsl_rng *rng_ptr, int dim, double sigma, double lower, double upper)
+void 
+integrand1(const double *x, size_t dim, size_t n, void *params,
+           double *values)
 { 
   // integrand: 1/sqrt(2pi*sigma^2) (x1+x2+...)^2 e^(-(x1^2+x2^2+...)/sigma^2)
-  // uniform sampling of the integrand for x_i's between lower and upper
-  double x_sum = 0;	    
-  double xsq_sum = 0;
+  // uniform sampling of the integrand for x_i's between lower and upper;
+  //  the sums are built up one coordinate at a time for a chunk of points
+  integrand_params *p = (integrand_params *) params;
+  double scale = 1./(2.*sqr(p->sigma));
+  const size_t chunk = 256;
+  double x_sum[chunk];	    
+  double xsq_sum[chunk];
 
-  for (int k = 1; k <= dim; k++)      // 3 dimensional
+  for (size_t i0 = 0; i0 < n; i0 += chunk)
   {
-    double x_tmp = gsl_ran_flat (rng_ptr, lower, upper);
-    x_sum += x_tmp;
-    xsq_sum += x_tmp*x_tmp;
+    size_t m = (n - i0 < chunk ? n - i0 : chunk);
+    for (size_t i = 0; i < m; i++)
+    {
+      x_sum[i] = 0.;
+      xsq_sum[i] = 0.;
+    }
+    for (size_t k = 0; k < dim; k++)
+    {
+      const double *x_k = x + k*n + i0;
+      for (size_t i = 0; i < m; i++)
+      {
+        x_sum[i] += x_k[i];
+        xsq_sum[i] += x_k[i]*x_k[i];
+      }
+    }
+    for (size_t i = 0; i < m; i++)
+    {
+      values[i0 + i] = p->norm*(x_sum[i]*x_sum[i])*exp(-xsq_sum[i]*scale);
+    }
   }
-
-  double factor = 1./sqrt(2.*M_PI*sqr(sigma));
-  return (pow(factor,dim)*(x_sum * x_sum)*exp(-xsq_sum/(2.*sqr(sigma))));	
 }
 
 //********************************************************************
@@ -7,13 +7,28 @@
 //  Revision history:
 //      06-Mar-2004  original version (from mc_integration.c)
 //      25-Feb-2012  switched functions and added gaussian sampling
+//      27-May-2021  statistical errors of the estimates from MCAccumulators
+//      01-Jun-2021  rng from RngStreams, which prints the master seed
+//      02-Jun-2021  integrands evaluated a block of points at a time by
+//                    an MCBatchIntegrator, with the points from a BulkRng
+//      03-Jun-2021  running MCAccumulators for all Nvec, each kind of
+//                    sampling stops at a target relative error; variance
+//                    reduction factor of gaussian sampling
 //
 //  Notes:
 //   * random numbers are generated uniformly and in gaussian distribution
-//   * uses the GSL random number functions
-//   * both the gsl_rng.h and gsl_randist.h header files are needed
-//   * the current version uses the gsl_rng_taus random number
-//      generator.  There are many other choices (see the GSL manual).
+//   * the points come in blocks from MCBatchIntegrator (xoshiro256+
+//      generators seeded from RngStreams; Box-Muller for the gaussian
+//      points) instead of one coordinate at a time from gsl_ran_flat
+//      and gsl_ran_gaussian; see mc_integration.cpp.
+//   * as in mc_integration.cpp, each checkpoint Nvec only adds the new
+//      points, and the uniform and the gaussian sampling each stop at
+//      the first checkpoint (after at least Nvec_stop points) where the
+//      estimated error is below target times the estimate.  After that
+//      their columns in the output do not change.
+//   * the variance reduction factor is (volume^2 variance of integrand1)
+//      / (variance of integrand2), the number of uniform points it takes
+//      to get the error of one gaussian point.
 //
 //******************************************************************
 
@@ -24,17 +39,27 @@
 using namespace std;		// we need this when .h is omitted
 #include <cmath>
 
-#include <gsl/gsl_rng.h>	// GSL random number generators
-#include <gsl/gsl_randist.h>	// GSL random distributions
+#include <ctime>
+
+#include "RngStreams.h"	// seeds and streams for the random numbers
+#include "MCAccumulator.h"	// average with error bar
+#include "MCBatchIntegrator.h"	// blocks of points and integrand values
 
 // function prototypes
-extern unsigned long int random_seed ();     // routine to generate a seed
 inline double sqr (double x) {return (x*x);};  // to square x
 
-// integrands for uniform and gaussian sampling
-double integrand1(gsl_rng *rng_ptr, int dim, double sigma, double lower, 
-                  double upper); 
-double integrand2(gsl_rng *rng_ptr, int dim, double sigma);  
+// parameters of the integrands
+struct integrand_params
+{
+  double sigma;                 // constant in gaussian
+  double norm;                  // 1/sqrt(2pi*sigma^2)^dim
+};
+
+// integrands for uniform and gaussian sampling, at n points x[k*n + i]
+void integrand1(const double *x, size_t dim, size_t n, void *params,
+                double *values); 
+void integrand2(const double *x, size_t dim, size_t n, void *params,
+                double *values);  
 
 //********************************************************************
 int
@@ -46,92 +71,150 @@ main (void)
   const int dim = 1;                // dimension of the integral
   double exact = double(dim)*sqr(sigma);   // exact answer from Mathematica
 
-  int Nvec = 0;		        // number of points used to evaluate integral
-  int Nvec_min = 100;            // mininum # of points to use
-  int Nvec_max = 1000000;        // maximum # of points to use
-  unsigned long int seed;
-  gsl_rng *rng_ptr;		// declare pointer to random number 
-                                //   generator (rng) 
-  rng_ptr = gsl_rng_alloc (gsl_rng_taus);	// allocate the rng 
+  long Nvec = 0;		        // number of points used to evaluate integral
+  long Nvec_min = 100;          // first checkpoint
+  long Nvec_stop = 1000;        // mininum # of points before stopping
+  long Nvec_max = 100000000;    // maximum # of points to use
+  double target;                // target relative error
+  integrand_params params = { sigma, pow(1./sqrt(2.*M_PI*sqr(sigma)),dim) };
+  mc_batch_function func1 = { &integrand1, dim, &params };
+  mc_batch_function func2 = { &integrand2, dim, &params };
+  MCBatchIntegrator integrator (dim,  // seeded from the master seed
+                      RngStreams::stream_seed (RngStreams::next_stream ()));
 
-  seed = random_seed ();    // generate a seed
-  cout << " Using " << seed << " to seed the RNG" << endl;
-  gsl_rng_set (rng_ptr, seed);	// seed the rng 
+  cout << "Target relative error (e.g. 0.001): ";
+  cin >> target;
 
   // output file mc_integration.dat has data on the average R 
   ofstream out;
   out.open ("mc_integration_new.dat");
 
-  cout << endl << "  Nvec   estimate  estimate2 exact    rel. error " 
-       << "   rel. error2"  << endl;
-  for (Nvec = Nvec_min; Nvec <= Nvec_max; Nvec *= 2)
+  cout << endl << "     Nvec   estimate  estimate2 exact    rel. error " 
+       << "   rel. error2   est. error   est. error2"  << endl;
+  clock_t start = clock ();
+  MCAccumulator integrand_acc;	// samples of integrand1, all Nvec
+  MCAccumulator integrand2_acc;	// samples of integrand2
+  double volume = pow((upper - lower),dim);
+  double integral_avg = 0., integral_err = 0.;
+  double integral2_avg = 0., integral2_err = 0.;
+  bool done = false;            // uniform sampling reached the target
+  bool done2 = false;           // gaussian sampling reached the target
+  for (Nvec = Nvec_min; Nvec <= Nvec_max && !(done && done2); Nvec *= 2)
   {
-    double integral_avg = 0;	// reset integral to zero 
-    for (int j = 0; j < Nvec; j++)
+    if (!done)
     {
-       // sample integrand1 (uniform sampling)	
-       integral_avg += integrand1(rng_ptr,dim,sigma,lower,upper);  
+      // sample integrand1 (uniform sampling) at the new points only
+      integrator.sample_uniform (func1, lower, upper,
+                                 Nvec - integrand_acc.count (), integrand_acc);
+      integral_avg = volume * integrand_acc.mean ();
+      integral_err = volume * integrand_acc.naive_error ();  // one sigma
     }
-    integral_avg = pow((upper - lower),dim) * integral_avg / double(Nvec);
     
-    double integral2_avg = 0;	// reset integral to zero 
-    for (int j = 0; j < Nvec; j++)
+    if (!done2)
     {
-      integral2_avg += integrand2(rng_ptr,dim,sigma);  // get integrand1
+      // sample integrand2 (gaussian sampling)
+      integrator.sample_gaussian (func2, sigma,
+                                  Nvec - integrand2_acc.count (), 
+                                  integrand2_acc);
+      integral2_avg = integrand2_acc.mean ();
+      integral2_err = integrand2_acc.naive_error ();
+      out << Nvec << " " << fixed << setprecision(8) << integral2_avg 
+          << " " << exact << " " << integral2_err << endl;
+      out.unsetf (ios::floatfield);
     }
-    integral2_avg = integral2_avg / double(Nvec);
     
-    cout << setw(6) << Nvec << "   " << fixed << setprecision(4) 
+    cout << setw(9) << Nvec << "   " << fixed << setprecision(4) 
          << setw(7) << integral_avg 
 	 << "   " << setw(7) << integral2_avg
 	 << "   " << exact 
 	 << "   " << scientific << abs(integral_avg-exact)/exact
-	 << "   " << scientific << abs(integral2_avg-exact)/exact << endl;
-    out << Nvec << " " << fixed << setprecision(8) << integral2_avg 
-        << " " << exact << endl;
+	 << "   " << scientific << abs(integral2_avg-exact)/exact
+	 << "   " << integral_err/exact << "   " << integral2_err/exact << endl;
+    cout.unsetf (ios::floatfield);
+    done = done || (Nvec >= Nvec_stop 
+                    && integral_err <= target*abs(integral_avg));
+    done2 = done2 || (Nvec >= Nvec_stop 
+                      && integral2_err <= target*abs(integral2_avg));
   }    
+  long total_points = integrand_acc.count () + integrand2_acc.count ();
+  cout << endl << "uniform sampling:  " << setw(9) << integrand_acc.count ()
+       << " points" << (done ? "" : " (target not reached)") << endl;
+  cout << "gaussian sampling: " << setw(9) << integrand2_acc.count ()
+       << " points" << (done2 ? "" : " (target not reached)") << endl;
+  cout << "variance reduction factor of gaussian sampling = " 
+       << setprecision(3) 
+       << sqr(volume) * integrand_acc.variance () / integrand2_acc.variance ()
+       << endl << endl;
+  double seconds = double (clock () - start) / CLOCKS_PER_SEC;
+  cout << total_points << " points in " << fixed << setprecision(2)
+       << seconds << " s (" << setprecision(1)
+       << 1.e9 * seconds / double (total_points) << " ns per point)" << endl;
   cout << "Data also output to mc_integration_new.dat." << endl;
 
-  gsl_rng_free (rng_ptr);	// free the random number generator 
   out.close ();			// close the output file
 
   return 0;
 }
 
 //********************************************************************
-double 
-integrand1(gsl_rng *rng_ptr, int dim, double sigma, double lower, double upper)
+void 
+integrand1(const double *x, size_t dim, size_t n, void *params,
+           double *values)
 { 
   // integrand: 1/sqrt(2pi*sigma^2) (x1+x2+...)^2 e^(-(x1^2+x2^2+...)/sigma^2)
-  // uniform sampling of the integrand for x_i's between lower and upper
-  double x_sum = 0;	    
-  double xsq_sum = 0;
-
-  for (int k = 1; k <= dim; k++)      // 3 dimensional
+  // uniform sampling of the integrand for x_i's between lower and upper;
+  //  the sums are built up one coordinate at a time for a chunk of points
+  integrand_params *p = (integrand_params *) params;
+  double scale = 1./(2.*sqr(p->sigma));
+  const size_t chunk = 256;
+  double x_sum[chunk];	    
+  double xsq_sum[chunk];
+
+  for (size_t i0 = 0; i0 < n; i0 += chunk)
   {
-    double x_tmp = gsl_ran_flat (rng_ptr, lower, upper);
-    x_sum += x_tmp;
-    xsq_sum += x_tmp*x_tmp;
+    size_t m = (n - i0 < chunk ? n - i0 : chunk);
+    for (size_t i = 0; i < m; i++)
+    {
+      x_sum[i] = 0.;
+      xsq_sum[i] = 0.;
+    }
+    for (size_t k = 0; k < dim; k++)
+    {
+      const double *x_k = x + k*n + i0;
+      for (size_t i = 0; i < m; i++)
+      {
+        x_sum[i] += x_k[i];
+        xsq_sum[i] += x_k[i]*x_k[i];
+      }
+    }
+    for (size_t i = 0; i < m; i++)
+    {
+      values[i0 + i] = p->norm*(x_sum[i]*x_sum[i])*exp(-xsq_sum[i]*scale);
+    }
   }
-
-  double factor = 1./sqrt(2.*M_PI*sqr(sigma));
-  return (pow(factor,dim)*(x_sum * x_sum)*exp(-xsq_sum/(2.*sqr(sigma))));	
 }
 
 //********************************************************************
-double 
-integrand2(gsl_rng *rng_ptr, int dim, double sigma)
+void 
+integrand2(const double *x, size_t dim, size_t n, void *, double *values)
 { // integrand: (x1+x2+...)^2
   // Gaussian sampling of the integrand for x_i's with sigma
-  double x_sum = 0;	    
-
-  for (int k = 1; k <= dim; k++)      // 3 dimensional
+  for (size_t i = 0; i < n; i++)
   {
-    double x_tmp = gsl_ran_gaussian (rng_ptr, sigma);
-    x_sum += x_tmp;
+    values[i] = 0.;
+  }
+  for (size_t k = 0; k < dim; k++)
+  {
+    const double *x_k = x + k*n;
+    for (size_t i = 0; i < n; i++)
+    {
+      values[i] += x_k[i];          // x_sum for point i
+    }
+  }
+  for (size_t i = 0; i < n; i++)
+  {
+    values[i] = values[i]*values[i];	// integrand1 is square of sum
   }
-
-  return (x_sum * x_sum);	// integrand1 is square of sum
 }
 
 //********************************************************************
@@ -9,6 +9,7 @@
 //      02/19/05  added more comments and math.h
 //      02/14/06  added output comment
 //	04/15/2021	Cameron Willoughby: Changed it to run 10 walks 10 times for average distance
+//      06/01/21  rng from RngStreams (seed 0: RNG_SEED or /dev/urandom)
 //  Notes:
 //   * implements method 2 from the list in section 6.10
 //      of the Landau/Paez text.
@@ -32,8 +33,7 @@ using namespace std;		// we need this when .h is omitted
 #include <gsl/gsl_rng.h>	// GSL random number generators
 #include <gsl/gsl_randist.h>	// GSL random distributions
 
-// function prototypes
-extern unsigned long int random_seed ();   // routine to generate a seed
+#include "RngStreams.h"	// seeds and streams for the GSL generators
 
 //********************************************************************
 int
@@ -53,16 +53,10 @@ main (void)
   gsl_rng *rng_ptr;		// declare pointer to random number 
                                 //   generator (rng) 
 
-  rng_ptr = gsl_rng_alloc (gsl_rng_taus);	// allocate the rng 
   cout << "Enter a long integer as a seed or 0 to generate one: ";
   cin >> seed;
-  if (seed == 0)
-    {				// generate a seed from /dev/random
-      seed = random_seed ();
-    }
-
-  cout << " Using " << seed << " to seed the RNG" << endl;
-  gsl_rng_set (rng_ptr, seed);	// seed the rng 
+  RngStreams::init (seed);	// 0: from RNG_SEED or /dev/urandom
+  rng_ptr = RngStreams::thread_rng ();	// seeded from the master seed
 
   // output file random_walks.dat holds all the walks
   ofstream out;
@@ -91,7 +85,6 @@ for(int j = 0; j < 100; j++){
 }//jloop
 out  << endl << npts << " " << r/100.0;
 }//kloop
-  gsl_rng_free (rng_ptr);	// free the random number generator
   out.close ();			// close the output file
 
   return (0);
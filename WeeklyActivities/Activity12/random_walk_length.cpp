@@ -9,6 +9,9 @@
 //                 average distance scales with the number of random steps
 //      02/19/05  added more comments and math.h
 //      02/14/06  minor upgrades and output comment
+//      05/27/21  average R from an MCAccumulator, with its error bar
+//                 as a third column
+//      06/01/21  rng from RngStreams (seed 0: RNG_SEED or /dev/urandom)
 //
 //  Notes:
 //   * implements method 2 from the list in section 6.10
@@ -33,8 +36,8 @@ using namespace std;		// we need this when .h is omitted
 #include <gsl/gsl_rng.h>	// GSL random number generators
 #include <gsl/gsl_randist.h>	// GSL random distributions
 
-// function prototypes
-extern unsigned long int random_seed ();    // routine to generate a seed
+#include "RngStreams.h"	// seeds and streams for the GSL generators
+#include "MCAccumulator.h"	// average with error bar
 
 //********************************************************************
 int
@@ -52,21 +55,15 @@ main (void)
   double x = 0.;		// current x 
   double y = 0.;		// current y 
 
-  double R_avg;			// average distance from origin (at end of walk)
+  MCAccumulator R_acc;		// distance from origin (at end of walk)
 
   gsl_rng *rng_ptr;		// declare pointer to random number 
                                 //   generator (rng) 
 
-  rng_ptr = gsl_rng_alloc (gsl_rng_taus);	// allocate the rng 
   cout << "Enter a long integer as a seed or 0 to generate one: ";
   cin >> seed;
-  if (seed == 0)
-    {				// generate a seed from /dev/random
-      seed = random_seed ();
-    }
-
-  cout << " Using " << seed << " to seed the RNG" << endl;
-  gsl_rng_set (rng_ptr, seed);	// seed the rng 
+  RngStreams::init (seed);	// 0: from RNG_SEED or /dev/urandom
+  rng_ptr = RngStreams::thread_rng ();	// seeded from the master seed
 
   // output file random_walk_length.dat has data on the average R 
   ofstream out;
@@ -76,7 +73,7 @@ main (void)
   for (npts = 10; npts <= 100000; npts *= 2)
     {
       trials =  int( sqrt (double(npts)) );  // Sqrt[npts] trials recommended
-      R_avg = 0.;		             // reset the average length
+      R_acc.reset ();		             // reset the average length
       for (int i = 0; i < trials; i++)	     // make "trials" runs and average
 	{
 	  x = y = 0;		// reset to origin 
@@ -87,15 +84,13 @@ main (void)
 	      x += delta_x;
 	      y += delta_y;
 	    }
-	  R_avg += sqrt (x * x + y * y);	// accumulate final distances
+	  R_acc.add (sqrt (x * x + y * y));	// accumulate final distances
 	}
-      R_avg /= (double) trials;	        // get the average
       
-      out << npts << " " << R_avg << endl;
+      out << npts << " " << R_acc.mean () << " " << R_acc.error () << endl;
     }
   cout << "Output random walk length to random_walk_length.dat." << endl; 
 
-  gsl_rng_free (rng_ptr);	// free the random number generator 
   out.close ();			// close the output file
 
   return 0;
@@ -0,0 +1,212 @@
+//  file: random_walk_length_new.cpp
+//
+//  Program to check sqrt(N) length of random walks, with the trials
+//   spread over OpenMP threads
+//
+//  Revision history:
+//      05/30/21  original version (from random_walk_length.cpp)
+//      06/01/21  substreams and thread generators from RngStreams
+//      06/06/21  substreams with set_stream on xoshiro256+, so no two
+//                 (npts, trial) pairs share a walk
+//
+//  Notes:
+//   * same walks as random_walk_length.cpp (steps uniform in
+//      [-sqrt(2),sqrt(2)] in x and y), but instead of sqrt(npts) trials
+//      for each npts, trials are added in rounds until the relative
+//      error of the average R is below a target.  Since the relative
+//      width of the R distribution does not depend on npts, every npts
+//      ends up with about the same number of trials.
+//   * trial i for length npts restarts the thread's generator as
+//      RngStreams stream npts*2^32 + i (a hash of the master seed and
+//      the stream number), so a walk does not depend on which thread ran
+//      it or how many threads there are.  The generator is xoshiro256+
+//      with its state set from the whole 64-bit hash, so every (npts, i)
+//      has its own sequence.  (gsl_rng_set on taus keeps only 32 bits of
+//      the seed, which made some trials copies of others and some walks
+//      prefixes of walks at another npts.)
+//   * the trials are independent, so the errors are the naive ones
+//      (sqrt(variance/trials)); the blocking estimate of error() would
+//      agree on average but fluctuates more.
+//   * each thread fills its own MCAccumulators and histogram, which are
+//      merged at the end of every round.  With a fixed number of threads
+//      a given seed reproduces the output exactly; with a different
+//      number only the roundoff of the sums changes.
+//   * <R^2> = (4/3) npts, and the distribution of r = R/sqrt(npts)
+//      approaches (r/s^2) exp(-r^2/(2 s^2)) with s^2 = 2/3, so that
+//      <R> = sqrt(pi/4 <R^2>) = 1.0233 sqrt(npts).
+//   * output: random_walk_length_new.dat has npts, trials, <R> and its
+//      error, sqrt(<R^2>) and its error; random_walk_length_new_dist.dat
+//      has the distribution of r for each npts, in blocks separated by
+//      two blank lines (gnuplot index 0, 1, ...).
+//   * compile with make -f make_random_walk_length_new (needs -fopenmp)
+//
+//******************************************************************
+
+// include files
+#include <iostream>		// cout and cin
+#include <iomanip>		// manipulators like setprecision
+#include <fstream>		// file input and output
+#include <vector>
+#include <cmath>
+using namespace std;		// we need this when .h is omitted
+#include <omp.h>
+
+#include <gsl/gsl_rng.h>	// GSL random number generators
+#include <gsl/gsl_randist.h>	// GSL random distributions
+
+#include "RngStreams.h"	// seeds and streams for the GSL generators
+#include "MCAccumulator.h"	// averages with error bars, mergeable
+
+//********************************************************************
+int
+main (void)
+{
+  int npts;			// size of random walk
+  unsigned long int seed;       // master seed for all the substreams
+  double target;		// target relative error of <R>
+  int num_threads;
+
+  const double lower = -sqrt (2.);	// lower limit of uniform range
+  const double upper = sqrt (2.);	// upper limit of uniform range
+
+  const long min_trials = 1000;	// first round for each npts
+  const int num_bins = 100;	// histogram of r = R/sqrt(npts)
+  const double r_max = 4.;	// on [0,r_max]
+  const double bin_width = r_max / num_bins;
+
+  cout << "Enter a long integer as a seed or 0 to generate one: ";
+  cin >> seed;
+  RngStreams::init (seed);	// 0: from RNG_SEED or /dev/urandom
+  seed = RngStreams::master_seed ();
+  cout << "Target relative error of <R> (e.g. 0.001): ";
+  cin >> target;
+  cout << "Number of threads (0 = all): ";
+  cin >> num_threads;
+  if (num_threads <= 0)
+    {
+      num_threads = omp_get_max_threads ();
+    }
+
+  // accumulators and histogram per thread
+  vector<MCAccumulator> R_thread (num_threads);
+  vector<MCAccumulator> R2_thread (num_threads);
+  vector< vector<long> > hist_thread (num_threads,
+                                      vector<long> (num_bins + 1));
+
+  ofstream out;
+  out.open ("random_walk_length_new.dat");
+  out << "# seed = " << seed << ", target relative error = " << target
+      << endl;
+  out << "#  npts    trials      <R>       error      sqrt(<R^2>)  error"
+      << endl;
+  ofstream dist_out;
+  dist_out.open ("random_walk_length_new_dist.dat");
+
+  double start = omp_get_wtime ();
+  long long total_steps = 0;
+
+  // go through walks of different lengths
+  for (npts = 10; npts <= 100000; npts *= 2)
+    {
+      MCAccumulator R_acc;	// distance from origin (at end of walk)
+      MCAccumulator R2_acc;	// its square
+      vector<long> hist (num_bins + 1, 0);	// last bin: r >= r_max
+      long trials = 0;
+      long round_trials = min_trials;
+
+      while (round_trials > 0)
+	{
+	  long begin = trials;
+	  long end = trials + round_trials;
+#pragma omp parallel num_threads(num_threads)
+	  {
+	    int t = omp_get_thread_num ();
+	    gsl_rng *rng_ptr = RngStreams::thread_rng ();
+	    R_thread[t].reset ();
+	    R2_thread[t].reset ();
+	    hist_thread[t].assign (num_bins + 1, 0);
+	    long i;
+#pragma omp for schedule(static)
+	    for (i = begin; i < end; i++)
+	      {
+		RngStreams::set_stream (rng_ptr,
+					(unsigned long long) npts << 32 | i);
+		double x = 0.;
+		double y = 0.;
+		for (int j = 0; j < npts; j++)
+		  {
+		    x += gsl_ran_flat (rng_ptr, lower, upper);
+		    y += gsl_ran_flat (rng_ptr, lower, upper);
+		  }
+		double R2 = x * x + y * y;
+		R_thread[t].add (sqrt (R2));
+		R2_thread[t].add (R2);
+		int bin = int (sqrt (R2 / npts) / bin_width);
+		hist_thread[t][bin < num_bins ? bin : num_bins]++;
+	      }
+	  }
+	  for (int t = 0; t < num_threads; t++)
+	    {
+	      R_acc.merge (R_thread[t]);
+	      R2_acc.merge (R2_thread[t]);
+	      for (int b = 0; b <= num_bins; b++)
+		{
+		  hist[b] += hist_thread[t][b];
+		}
+	    }
+	  trials = end;
+
+	  // enough trials?  If not, estimate how many more are needed
+	  //  (error ~ 1/sqrt(trials)), at most four times as many again
+	  double rel_error = R_acc.naive_error () / R_acc.mean ();
+	  round_trials = 0;
+	  if (rel_error > target)
+	    {
+	      double ratio = rel_error / target;
+	      round_trials = long (trials * (1.1 * ratio * ratio - 1.)) + 1;
+	      round_trials = (round_trials > 4 * trials ? 4 * trials
+			      : round_trials);
+	    }
+	}
+      total_steps += (long long) trials * npts;
+
+      double R_rms = sqrt (R2_acc.mean ());
+      double R_rms_error = R2_acc.naive_error () / (2. * R_rms);
+      out << setw (6) << npts << "  " << setw (8) << trials << "  "
+	  << scientific << setprecision (5) << R_acc.mean () << "  "
+	  << setprecision (2) << R_acc.naive_error () << "  "
+	  << setprecision (5) << R_rms << "  " << setprecision (2)
+	  << R_rms_error << endl;
+      out.unsetf (ios::floatfield);
+      cout << setw (6) << npts << "  " << setw (8) << trials
+	   << " trials   <R>/sqrt(npts) = " << fixed << setprecision (4)
+	   << R_acc.mean () / sqrt (double (npts)) << "   sqrt(<R^2>/npts) = "
+	   << R_rms / sqrt (double (npts)) << endl;
+      cout.unsetf (ios::floatfield);
+
+      // distribution of r = R/sqrt(npts), normalized, with the limit
+      const double s2 = 2. / 3.;
+      dist_out << "# npts = " << npts << ", " << trials << " trials" << endl;
+      dist_out << "#   r       P(r)        limit" << endl;
+      for (int b = 0; b < num_bins; b++)
+	{
+	  double r = (b + 0.5) * bin_width;
+	  dist_out << fixed << setprecision (3) << setw (6) << r << "  "
+		   << setprecision (6) << setw (10)
+		   << hist[b] / (double (trials) * bin_width) << "  "
+		   << setw (10) << r / s2 * exp (-r * r / (2. * s2)) << endl;
+	}
+      dist_out << endl << endl;
+    }
+  double elapsed = omp_get_wtime () - start;
+  cout << "Output random walk length to random_walk_length_new.dat and "
+       << "distributions to random_walk_length_new_dist.dat." << endl;
+  cout << fixed << setprecision (2) << total_steps * 1.e-6 << " million "
+       << "steps in " << elapsed << " s on " << num_threads << " threads"
+       << endl;
+
+  out.close ();			// close the output files
+  dist_out.close ();
+
+  return 0;
+}
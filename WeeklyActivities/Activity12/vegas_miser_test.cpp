@@ -0,0 +1,238 @@
+//  file: vegas_miser_test.cpp
+//
+//  Demo of the native Monte Carlo integrators (MCBatchIntegrator,
+//   MiserIntegrator, VegasIntegrator) on the integrals of
+//   gsl_monte_carlo_test.cpp
+//
+//  Revision history:
+//      06/03/21  original version (from gsl_monte_carlo_test.cpp)
+//      06/07/21  2-D peaked gaussian, where vegas is stratified
+//
+//  Notes:
+//   * the integral of (x1 + ... + x10)^2 over the unit hypercube is
+//      155/6.  The calls are the same as in gsl_monte_carlo_test.cpp
+//      (plain and miser with 100000, vegas with a 10000 warm-up and then
+//      two runs of 50000, each of 5 iterations), so the results and
+//      sigmas can be compared directly with GSL's.  In 10 dimensions
+//      vegas never has enough calls for more than one box per bin.
+//   * a normalized gaussian of width 0.1 at the center of the unit
+//      square (exact: erf(0.5/(0.1 sqrt(2)))^2) is the stratified test:
+//      in 2 dimensions 10000 calls give 50 boxes per coordinate.
+//   * the last part times vegas with more calls per iteration; set
+//      OMP_NUM_THREADS to see how it scales (the results do not depend
+//      on the number of threads).
+//   * compile with make -f make_vegas_miser_test (needs -fopenmp)
+//
+//*********************************************************************//
+
+// include files
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <ctime>
+using namespace std;
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "RngStreams.h"		// master seed
+#include "MCBatchIntegrator.h"
+#include "MiserIntegrator.h"
+#include "VegasIntegrator.h"
+
+// Function prototypes
+void my_integrand (const double *x, size_t dim, size_t n, void *params,
+                   double *values);
+void gaussian_integrand (const double *x, size_t dim, size_t n,
+                         void *params, double *values);
+void display_results (const char *title, double result, double error,
+                      double exact);
+double wall_time ();
+
+const double gaussian_width = 0.1;
+
+//*********************************************************************//
+
+int
+main ()
+{
+  // details of the integrand
+  const int dimension = 10;   // dimension of integral
+
+  // set upper and lower limits
+  double xl[dimension] = { 0.,0.,0.,0.,0.,0.,0.,0.,0.,0.};     // (all 0's)
+  double xu[dimension] = { 1.,1.,1.,1.,1.,1.,1.,1.,1.,1.};     // (all 1's)
+
+  // set up the function for Monte Carlo routines
+  mc_batch_function my_function = { &my_integrand, dimension, NULL };
+
+  size_t calls = 100000;
+  double result, error;		// result and error
+  double exact = 155./6.;
+
+
+  // first use plain, uniform sampling
+  MCBatchIntegrator plain (dimension,
+                      RngStreams::stream_seed (RngStreams::next_stream ()));
+  MCAccumulator plain_acc;
+  plain.sample_uniform (my_function, 0., 1., calls, plain_acc);
+  display_results ("plain", plain_acc.mean (), plain_acc.naive_error (),
+                   exact);
+
+
+  // now use the "miser" routine
+  MiserIntegrator miser (dimension,
+                      RngStreams::stream_seed (RngStreams::next_stream ()));
+  miser.integrate (my_function, xl, xu, calls, &result, &error);
+
+  display_results ("miser", result, error, exact);
+
+
+  // finally, use the "vegas" routine
+  VegasIntegrator vegas (dimension,
+                      RngStreams::stream_seed (RngStreams::next_stream ()));
+
+    // first do 10000 points as a warm-up
+  vegas.integrate (my_function, xl, xu, 10000, &result, &error);
+  display_results ("vegas warm-up", result, error, exact);
+
+    // then watch convergence 50000 at a time
+  cout << "converging... " << endl;
+  for (int i=0; i < 2; i++)
+    {
+      vegas.integrate (my_function, xl, xu, calls / 2, &result, &error);
+      cout
+	<< "result = " << setprecision (6) << result
+	<< " sigma = " << setprecision (6) << error
+	<< " chisq/dof = " << setprecision (1) << vegas.get_chisq ()
+        << endl;
+    }
+
+  display_results ("vegas final", result, error, exact);
+
+  // 2-D peaked gaussian: plain, miser, and vegas in stratified mode
+  const int dim2 = 2;
+  double xl2[dim2] = { 0., 0. };
+  double xu2[dim2] = { 1., 1. };
+  mc_batch_function gaussian = { &gaussian_integrand, dim2, NULL };
+  double erf_half = erf (0.5 / (gaussian_width * sqrt (2.)));
+  double exact2 = erf_half * erf_half;
+
+  MCBatchIntegrator plain2 (dim2,
+                      RngStreams::stream_seed (RngStreams::next_stream ()));
+  MCAccumulator plain2_acc;
+  plain2.sample_uniform (gaussian, 0., 1., calls, plain2_acc);
+  display_results ("2-D gaussian, plain", plain2_acc.mean (),
+                   plain2_acc.naive_error (), exact2);
+
+  MiserIntegrator miser2 (dim2,
+                      RngStreams::stream_seed (RngStreams::next_stream ()));
+  miser2.integrate (gaussian, xl2, xu2, calls, &result, &error);
+  display_results ("2-D gaussian, miser", result, error, exact2);
+
+  VegasIntegrator vegas2 (dim2,
+                      RngStreams::stream_seed (RngStreams::next_stream ()));
+  vegas2.integrate (gaussian, xl2, xu2, 10000, &result, &error);
+  display_results ("2-D gaussian, vegas warm-up", result, error, exact2);
+  for (int i=0; i < 2; i++)
+    {
+      vegas2.integrate (gaussian, xl2, xu2, calls / 2, &result, &error);
+    }
+  cout << "stratified: " << (vegas2.is_stratified () ? "yes" : "no")
+       << ", chisq/dof = " << setprecision (1) << vegas2.get_chisq ()
+       << endl;
+  display_results ("2-D gaussian, vegas final", result, error, exact2);
+
+  // timing: 5 iterations of 10^7 points
+  int num_threads = 1;
+#ifdef _OPENMP
+  num_threads = omp_get_max_threads ();
+#endif
+  double start = wall_time ();
+  vegas.integrate (my_function, xl, xu, 10000000, &result, &error);
+  double elapsed = wall_time () - start;
+  display_results ("vegas 5 x 10^7", result, error, exact);
+  cout << setprecision (2) << elapsed << " s on " << num_threads
+       << " threads (" << setprecision (1) << 1.e9 * elapsed / 5.e7
+       << " ns per point)" << endl;
+
+  return 0;
+}
+
+//*********************************************************************//
+
+void
+my_integrand (const double *x, size_t dim, size_t n, void *,
+              double *values)
+{
+  for (size_t i = 0; i < n; i++)
+    {
+      values[i] = 0.;
+    }
+  for (size_t k = 0; k < dim; k++)
+    {
+      for (size_t i = 0; i < n; i++)
+        {
+          values[i] += x[k*n + i];	// sum for point i
+        }
+    }
+  for (size_t i = 0; i < n; i++)
+    {
+      values[i] = values[i]*values[i];
+    }
+}
+
+// normalized gaussian of width gaussian_width centered at (1/2, 1/2, ...)
+void
+gaussian_integrand (const double *x, size_t dim, size_t n, void *,
+                    double *values)
+{
+  const double a = 1. / (2. * gaussian_width * gaussian_width);
+  const double norm = pow (a / M_PI, 0.5 * double (dim));
+  for (size_t i = 0; i < n; i++)
+    {
+      values[i] = 0.;
+    }
+  for (size_t k = 0; k < dim; k++)
+    {
+      for (size_t i = 0; i < n; i++)
+        {
+          double dx = x[k*n + i] - 0.5;
+          values[i] += dx*dx;
+        }
+    }
+  for (size_t i = 0; i < n; i++)
+    {
+      values[i] = norm * exp (-a * values[i]);
+    }
+}
+
+//*********************************************************************//
+
+void
+display_results (const char *title, double result, double error,
+                 double exact)
+{
+  cout.setf (ios::fixed, ios::floatfield);	// output in fixed format
+  cout.precision (6);		// 6 digits past the decimal point
+
+  cout << title << " ==================" << endl;
+  cout << "result = " << setw (9) << result << endl;
+  cout << "sigma  = " << setw (9) << error << endl;
+  cout << "exact  = " << setw (9) << exact << endl;
+  cout << "error  = " << setw (9) << result - exact
+    << " = " << setprecision (1) << setw (2)
+    << fabs (result - exact) / error << " sigma " << endl << endl;
+}
+
+// wall-clock time in seconds
+double
+wall_time ()
+{
+#ifdef _OPENMP
+  return omp_get_wtime ();
+#else
+  return double (clock ()) / CLOCKS_PER_SEC;
+#endif
+}
@@ -0,0 +1,494 @@
+//  file: IsingEngine.cpp
+//
+//  Member functions for the IsingEngine class (checkerboard Metropolis
+//   for the two-dimensional Ising model).
+//
+//  Revision history:
+//      20-May-2021  original version
+//      06-Jun-2021  strip rng's are RngStreams::xoshiro_type
+//
+//  Notes:
+//   * color c holds the sites with (i + j) % 2 == c.  All four neighbours
+//      of a site have the other color, so during a half-sweep the spins
+//      being updated only read spins that are not changing: the sites of
+//      one color can be visited in any order, or at the same time.  A
+//      red half-sweep followed by a black one leaves the Boltzmann
+//      distribution invariant, as the typewriter sweep of ising_opt does,
+//      so the two give the same averages (within statistical errors).
+//   * this only works for even L; with odd L the periodic wrap puts two
+//      sites of the same color next to each other.
+//   * seeds for the strip rng's come from one seed through the SplitMix64
+//      mixer, instead of calling random_seed() once per strip (which with
+//      the time-based version in random_seed.cpp gives the same seed to
+//      every strip).  The strip rng's are xoshiro256+ (RngStreams), which
+//      use the whole 64-bit seed; taus would keep only 32 bits of it, so
+//      with many replicas and strips two of them could share a sequence.
+//   * exp() is evaluated only in set_kT(), for the five possible values
+//      of s*h, not once per uphill move.
+//   * Wolff: a cluster grows from a random site, adding each neighbour
+//      with a satisfied bond (J s_i s_j > 0) with probability
+//      p = 1 - exp(-2|J|/kT), and the whole cluster is flipped.
+//   * Swendsen-Wang: every satisfied bond is activated with the same p,
+//      the clusters joined by active bonds are found by union-find, and
+//      each cluster is flipped with probability 1/2.  Each strip links
+//      its own sites in parallel, then the bonds between strips are
+//      joined in a short serial pass.  Roots are always the smallest
+//      site id of a cluster, so the labels do not depend on the order of
+//      the unions, and the flip of a cluster is a hash of its root: the
+//      result does not depend on the number of threads either.
+//   * compile with -fopenmp to run sweep() on several threads.
+//
+//******************************************************************
+
+// include files
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+using namespace std;
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "IsingEngine.h"
+#include "RngStreams.h"		// xoshiro_type
+
+//********************************************************************
+// SplitMix64: a good 64-bit mixer, used to derive one seed per stream
+static inline unsigned long long
+mix64 (unsigned long long z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return (z ^ (z >> 31));
+}
+
+const int max_strips = 64;	// strips of rows (and rng streams) per lattice
+
+//********************************************************************
+// Constructor for IsingEngine
+IsingEngine::IsingEngine (int L_in, double kT_in, unsigned long int seed,
+                          double J_in)
+{
+  if (L_in < 2 || L_in % 2 != 0)
+  {
+    cerr << "IsingEngine: L = " << L_in << " must be even and at least 2"
+         << endl;
+    exit (1);
+  }
+  L = L_in;
+  num_sites = L * L;
+  J = J_in;
+  threads = 0;
+  config.assign (num_sites, 1);
+
+  make_strips (seed);
+  set_kT (kT_in);
+  randomize ();
+}
+
+// Copy constructor: the copy continues every rng stream independently
+IsingEngine::IsingEngine (const IsingEngine &other)
+  : L (other.L), num_sites (other.num_sites), kT (other.kT), J (other.J),
+    threads (other.threads), config (other.config),
+    bond_sum (other.bond_sum), num_strips (other.num_strips),
+    strip_row (other.strip_row), rng (other.num_strips)
+{
+  for (int k = 0; k < 5; k++)
+  {
+    accept[k] = other.accept[k];
+  }
+  add_prob = other.add_prob;
+  for (int s = 0; s < num_strips; s++)
+  {
+    rng[s] = gsl_rng_clone (other.rng[s]);
+  }
+}
+
+// Destructor for IsingEngine
+IsingEngine::~IsingEngine ()
+{
+  for (int s = 0; s < num_strips; s++)
+  {
+    gsl_rng_free (rng[s]);
+  }
+}
+
+// Split the rows into strips and give each strip its own rng
+void
+IsingEngine::make_strips (unsigned long int seed)
+{
+  num_strips = (L / 2 < max_strips ? L / 2 : max_strips);
+  strip_row.resize (num_strips + 1);
+  for (int s = 0; s <= num_strips; s++)
+  {
+    strip_row[s] = int ((long long) s * L / num_strips);
+  }
+
+  rng.resize (num_strips);
+  unsigned long long key = mix64 (seed);
+  for (int s = 0; s < num_strips; s++)
+  {
+    rng[s] = gsl_rng_alloc (RngStreams::xoshiro_type);
+    unsigned long int strip_seed =
+      (unsigned long int) mix64 (key + (s + 1) * 0x9e3779b97f4a7c15ULL);
+    gsl_rng_set (rng[s], strip_seed);
+  }
+}
+
+//********************************************************************
+void
+IsingEngine::set_kT (double kT_in)
+{
+  kT = kT_in;
+  for (int k = 0; k < 5; k++)
+  {
+    int sh = 2 * k - 4;		// s*h from -4 to 4
+    double delta_energy = 2. * J * double (sh);
+    accept[k] = (delta_energy <= 0. ? 1. : exp (-delta_energy / kT));
+  }
+  add_prob = 1. - exp (-2. * fabs (J) / kT);
+}
+
+void
+IsingEngine::randomize ()
+{
+  for (int s = 0; s < num_strips; s++)
+  {
+    for (int id = strip_row[s] * L; id < strip_row[s + 1] * L; id++)
+    {
+      double random = gsl_rng_uniform (rng[s]);
+      config[id] = (random > 0.5 ? -1 : +1);
+    }
+  }
+  bond_sum = count_bonds ();
+}
+
+void
+IsingEngine::set_all (int spin_value)
+{
+  for (int id = 0; id < num_sites; id++)
+  {
+    config[id] = (spin_value < 0 ? -1 : +1);
+  }
+  bond_sum = 2LL * num_sites;
+}
+
+//********************************************************************
+int
+IsingEngine::neighbor (int id, int k) const
+{
+  int i = id % L;
+  int j = id / L;
+
+  switch (k)
+  {
+  case 0:
+    return ((i - 1 + L) % L + j * L);
+  case 1:
+    return ((i + 1) % L + j * L);
+  case 2:
+    return (i + (j - 1 + L) % L * L);
+  default:
+    return (i + (j + 1) % L * L);
+  }
+}
+
+long long
+IsingEngine::magnetization () const
+{
+  long long m = 0;
+  for (int id = 0; id < num_sites; id++)
+  {
+    m += config[id];
+  }
+  return (m);
+}
+
+double
+IsingEngine::calculate_energy () const
+{
+  return (-J * double (count_bonds ()));
+}
+
+// Same sum as calculate_energy() in ising_opt.cpp: bonds to the right
+//  and upward neighbours, periodic in both directions
+long long
+IsingEngine::count_bonds () const
+{
+  long long sum = 0;
+  for (int j = 0; j < L; j++)
+  {
+    const signed char *row = &config[j * L];
+    const signed char *up = &config[((j + 1) % L) * L];
+    for (int i = 0; i < L; i++)
+    {
+      sum += row[i] * (row[(i + 1) % L] + up[i]);
+    }
+  }
+  return (sum);
+}
+
+//********************************************************************
+// Metropolis update of the sites of one color in one strip
+long long
+IsingEngine::half_sweep (int color, int strip)
+{
+  gsl_rng *r = rng[strip];
+  long long delta_bonds = 0;
+
+  for (int j = strip_row[strip]; j < strip_row[strip + 1]; j++)
+  {
+    signed char *row = &config[j * L];
+    const signed char *down = &config[((j - 1 + L) % L) * L];
+    const signed char *up = &config[((j + 1) % L) * L];
+
+    for (int i = (color + j) & 1; i < L; i += 2)
+    {
+      int left = (i == 0 ? L - 1 : i - 1);
+      int right = (i == L - 1 ? 0 : i + 1);
+      int sh = row[i] * (row[left] + row[right] + down[i] + up[i]);
+      double p = accept[(sh + 4) >> 1];
+
+      if (p >= 1. || gsl_rng_uniform (r) < p)
+      {
+        row[i] = -row[i];
+        delta_bonds -= 2 * sh;
+      }
+    }
+  }
+  return (delta_bonds);
+}
+
+void
+IsingEngine::sweep ()
+{
+  for (int color = 0; color < 2; color++)
+  {
+    long long delta_bonds = 0;
+    int s;
+#ifdef _OPENMP
+    int num_threads = (threads > 0 ? threads : omp_get_max_threads ());
+#pragma omp parallel for schedule(static) reduction(+:delta_bonds) num_threads(num_threads)
+#endif
+    for (s = 0; s < num_strips; s++)
+    {
+      delta_bonds += half_sweep (color, s);
+    }
+    bond_sum += delta_bonds;
+  }
+}
+
+// One mcs visiting every site in order, like the loop in ising_opt.cpp,
+//  drawing random numbers from the first strip's stream
+void
+IsingEngine::sweep_sequential ()
+{
+  gsl_rng *r = rng[0];
+
+  for (int j = 0; j < L; j++)
+  {
+    signed char *row = &config[j * L];
+    const signed char *down = &config[((j - 1 + L) % L) * L];
+    const signed char *up = &config[((j + 1) % L) * L];
+
+    for (int i = 0; i < L; i++)
+    {
+      int left = (i == 0 ? L - 1 : i - 1);
+      int right = (i == L - 1 ? 0 : i + 1);
+      int sh = row[i] * (row[left] + row[right] + down[i] + up[i]);
+      double p = accept[(sh + 4) >> 1];
+
+      if (p >= 1. || gsl_rng_uniform (r) < p)
+      {
+        row[i] = -row[i];
+        bond_sum -= 2 * sh;
+      }
+    }
+  }
+}
+
+//********************************************************************
+// root of the union-find tree holding id, halving the path on the way
+static inline int
+find_root (int parent[], int id)
+{
+  while (parent[id] != id)
+  {
+    parent[id] = parent[parent[id]];
+    id = parent[id];
+  }
+  return (id);
+}
+
+// join the trees of a and b under the smaller root
+static inline void
+unite (int parent[], int a, int b)
+{
+  int ra = find_root (parent, a);
+  int rb = find_root (parent, b);
+  if (ra < rb)
+  {
+    parent[rb] = ra;
+  }
+  else if (rb < ra)
+  {
+    parent[ra] = rb;
+  }
+}
+
+// Grow a Wolff cluster from a random site, flipping each site as it
+//  joins, then fix bond_sum from the bonds across the cluster boundary
+int
+IsingEngine::wolff_step ()
+{
+  gsl_rng *r = rng[0];
+  if ((int) in_cluster.size () != num_sites)
+  {
+    in_cluster.assign (num_sites, 0);
+  }
+
+  int start = int (gsl_rng_uniform_int (r, num_sites));
+  cluster.clear ();
+  cluster.push_back (start);
+  in_cluster[start] = 1;
+  config[start] = -config[start];
+
+  for (size_t n = 0; n < cluster.size (); n++)
+  {
+    int id = cluster[n];
+    // spin a neighbour needs for a satisfied bond with id (before flips)
+    signed char want = (J > 0. ? -config[id] : config[id]);
+    for (int k = 0; k < 4; k++)
+    {
+      int nb = neighbor (id, k);
+      if (!in_cluster[nb] && config[nb] == want
+          && gsl_rng_uniform (r) < add_prob)
+      {
+        in_cluster[nb] = 1;
+        config[nb] = -config[nb];
+        cluster.push_back (nb);
+      }
+    }
+  }
+
+  long long delta_bonds = 0;	// only bonds leaving the cluster changed
+  for (size_t n = 0; n < cluster.size (); n++)
+  {
+    int id = cluster[n];
+    for (int k = 0; k < 4; k++)
+    {
+      int nb = neighbor (id, k);
+      if (!in_cluster[nb])
+      {
+        delta_bonds += 2 * config[id] * config[nb];
+      }
+    }
+  }
+  for (size_t n = 0; n < cluster.size (); n++)
+  {
+    in_cluster[cluster[n]] = 0;
+  }
+  bond_sum += delta_bonds;
+  return ((int) cluster.size ());
+}
+
+// Activate the satisfied right and up bonds of the sites in one strip
+//  and join the clusters inside the strip; up bonds out of the last row
+//  are only recorded in bond_up, for the serial pass
+void
+IsingEngine::link_strip (int strip)
+{
+  gsl_rng *r = rng[strip];
+  int *p = &parent[0];
+  int first = strip_row[strip] * L;
+  int last = strip_row[strip + 1] * L;	// one past the strip
+
+  for (int id = first; id < last; id++)
+  {
+    p[id] = id;
+  }
+  for (int id = first; id < last; id++)
+  {
+    for (int k = 1; k <= 3; k += 2)	// right and up
+    {
+      int nb = neighbor (id, k);
+      bool active = (J * config[id] * config[nb] > 0.
+                     && gsl_rng_uniform (r) < add_prob);
+      if (k == 3 && (nb < first || nb >= last))
+      {
+        bond_up[id] = active;
+      }
+      else if (active)
+      {
+        unite (p, id, nb);
+      }
+    }
+  }
+}
+
+// One Swendsen-Wang update of the whole lattice
+int
+IsingEngine::swendsen_wang_step ()
+{
+  if ((int) parent.size () != num_sites)
+  {
+    parent.resize (num_sites);
+    bond_up.assign (num_sites, 0);
+  }
+  int *p = &parent[0];
+  int s;
+#ifdef _OPENMP
+  int num_threads = (threads > 0 ? threads : omp_get_max_threads ());
+#endif
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+#endif
+  for (s = 0; s < num_strips; s++)
+  {
+    link_strip (s);
+  }
+
+  // bonds between strips
+  for (s = 0; s < num_strips; s++)
+  {
+    int j = strip_row[s + 1] - 1;
+    for (int id = j * L; id < (j + 1) * L; id++)
+    {
+      if (bond_up[id])
+      {
+        unite (p, id, neighbor (id, 3));
+      }
+    }
+  }
+
+  // flip each cluster with probability 1/2: bit 0 of a hash of its root
+  unsigned long long key = mix64 (gsl_rng_get (rng[0]));
+  int num_clusters = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+:num_clusters) num_threads(num_threads)
+#endif
+  for (s = 0; s < num_strips; s++)
+  {
+    for (int id = strip_row[s] * L; id < strip_row[s + 1] * L; id++)
+    {
+      int root = id;
+      while (p[root] != root)	// read only: other threads are reading too
+      {
+        root = p[root];
+      }
+      if (root == id)
+      {
+        num_clusters++;
+      }
+      if (mix64 (key + (unsigned long long) root) & 1)
+      {
+        config[id] = -config[id];
+      }
+    }
+  }
+
+  bond_sum = count_bonds ();
+  return (num_clusters);
+}
@@ -0,0 +1,93 @@
+//  file: IsingEngine.h
+//
+//  Header file for the IsingEngine class: the two-dimensional Ising model
+//   on an L x L periodic lattice with L chosen at run time, updated by
+//   Metropolis sweeps in red/black (checkerboard) order so each half-sweep
+//   can run in parallel.
+//
+//  Revision history:
+//      20-May-2021  original version, generalizes ising_opt.cpp
+//      24-May-2021  added Wolff and Swendsen-Wang cluster updates
+//
+//  Notes:
+//   * site id = i + j*L as in ising_opt.cpp, and neighbor(id,k) for
+//      k = 0..3 gives the same sites as nearest_neighbor[id][k] there
+//      (left, right, down, up), but is computed rather than stored.
+//   * the lattice is split into a fixed number of strips of rows, each
+//      with its own gsl_rng stream.  Threads work on whole strips, so a
+//      run depends only on the seed and not on the number of threads.
+//   * near kT = 2.27 the cluster updates wolff_step() and
+//      swendsen_wang_step() decorrelate the lattice much faster than
+//      Metropolis sweeps; they walk the same neighbor(id,k) layout.
+//
+#ifndef ISING_ENGINE_H
+#define ISING_ENGINE_H
+
+#include <vector>
+
+#include <gsl/gsl_rng.h>	// GSL random number generators
+
+class IsingEngine
+{
+public:
+  // L x L lattice (L even) at temperature kT; J is the coupling.  The
+  //  strip rng's are seeded from seed, and spins start random.
+  IsingEngine (int L, double kT, unsigned long int seed, double J = 1.);
+  IsingEngine (const IsingEngine &other);
+  ~IsingEngine ();
+
+  void set_kT (double kT);	// new temperature, same configuration
+  void set_threads (int num_threads) { threads = num_threads; };	// 0 = all
+  void randomize ();		// hot start: every spin +1 or -1 at random
+  void set_all (int spin);	// cold start: every spin = spin
+
+  void sweep ();		// one mcs: red half-sweep, then black
+  void sweep_sequential ();	// one mcs in typewriter order, as ising_opt
+  int wolff_step ();		// flip one Wolff cluster, returns its size
+  int swendsen_wang_step ();	// flip all SW clusters, returns their number
+
+  int get_L () const { return L; };
+  int get_num_sites () const { return num_sites; };
+  double get_kT () const { return kT; };
+  int spin (int id) const { return config[id]; };
+  int neighbor (int id, int k) const;	// k = 0..3: left, right, down, up
+
+  double energy () const { return -J * double (bond_sum); };	// tracked
+  long long magnetization () const;	// sum of the spins, O(N)
+  double calculate_energy () const;	// from scratch, O(N), for checks
+
+  int get_num_strips () const { return num_strips; };
+
+private:
+  IsingEngine &operator= (const IsingEngine &);	// not assignable
+
+  void make_strips (unsigned long int seed);
+  long long count_bonds () const;	// sum over bonds of s_i s_j, O(N)
+  long long half_sweep (int color, int strip);	// returns change in bond_sum
+  void link_strip (int strip);	// SW bonds and clusters within a strip
+
+  int L;			// linear size
+  int num_sites;		// L*L
+  double kT;			// temperature (in energy units)
+  double J;			// coupling (the "J" in the Ising model)
+  int threads;			// OpenMP threads for sweep(), 0 = all
+
+  std::vector<signed char> config;	// spins, +1 or -1
+  long long bond_sum;		// sum over bonds of s_i s_j, E = -J*bond_sum
+
+  // accept[(s*h+4)/2] = min(1, exp(-2 J s h / kT)) for s*h = -4..4
+  double accept[5];
+  double add_prob;		// 1 - exp(-2|J|/kT): bond joins a cluster
+
+  // work space for the cluster updates, sized on first use
+  std::vector<int> cluster;	// sites of the Wolff cluster
+  std::vector<char> in_cluster;	// 1 for sites in the Wolff cluster
+  std::vector<int> parent;	// SW union-find forest
+  std::vector<char> bond_up;	// SW bond to the site above is active
+
+  int num_strips;		// number of strips of rows
+  std::vector<int> strip_row;	// strip s has rows strip_row[s]..strip_row[s+1]-1
+  std::vector<gsl_rng *> rng;	// one stream per strip
+};
+
+#endif
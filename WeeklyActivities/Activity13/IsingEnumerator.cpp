@@ -0,0 +1,330 @@
+//  file: IsingEnumerator.cpp
+//
+//  Member functions for the IsingEnumerator class (exact density of
+//   states by Gray-code enumeration).
+//
+//  Revision history:
+//      25-May-2021  original version
+//
+//  Notes:
+//   * bit k of a configuration is spin k, 1 = up and 0 = down, as in
+//      the base-2 counting of next_configuration() in sampling_test.cpp.
+//   * in the binary reflected Gray code, step t (t = 1, 2, ...) flips
+//      the bit numbered by the trailing zeros of t.
+//   * the sites are split into a low block 0..num_low-1 and the rest.
+//      The low block only touches the rest through a few boundary sites
+//      (a ring: sites num_low and N-1; a lattice: the rows above and
+//      below).  So, for each of the 2^num_boundary boundary
+//      configurations B, one Gray-code walk over the low block gives the
+//      histogram of the bond sum of the bonds that touch it.  Then a
+//      walk over the other sites, with O(1) updates of the bond sum of
+//      the remaining bonds and of B, adds the histogram for B shifted by
+//      that bond sum: each step accounts for 2^num_low configurations.
+//   * both walks split their outer loop over OpenMP threads, each with
+//      its own histogram.
+//
+//******************************************************************
+
+// include files
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "IsingEnumerator.h"
+
+const int max_table_bits = 24;	// num_low + num_boundary at most this
+const int max_prefix_bits = 8;	// at most 256 separate outer walks
+
+//********************************************************************
+// Gray-code walk over the spins listed in site[0..num_free-1], starting
+//  from the current spin[] with bond_sum = sum over the bonds being
+//  tracked.  h sums spin[] over the neighbours, so spins that must not
+//  count (outside the tracked bonds) are set to 0.  visit(bond_sum, B)
+//  is called for every configuration, B being updated with bit[k] for
+//  each flip of site k (bit[k] = 0 if k is not a boundary site).
+template <int Z, class Visit>
+static inline void
+gray_walk (int spin[], const int nb[], const int site[], int num_free,
+           const int bit[], int bond_sum, int B, Visit &visit)
+{
+  visit (bond_sum, B);
+  unsigned long long num_steps = 1ULL << num_free;
+  for (unsigned long long t = 1; t < num_steps; t++)
+  {
+    int k = site[__builtin_ctzll (t)];	// the spin that flips
+    const int *nbk = &nb[k * Z];
+    int h = 0;
+    for (int n = 0; n < Z; n++)
+    {
+      h += spin[nbk[n]];
+    }
+    bond_sum -= 2 * spin[k] * h;	// delta_E = 2 J s h
+    spin[k] = -spin[k];
+    B ^= bit[k];
+    visit (bond_sum, B);
+  }
+}
+
+// histogram of the bond sum, for the walk over the low block
+struct HistogramVisit
+{
+  long long *count;		// count[offset + bond_sum]
+  int offset;
+  void operator() (int bond_sum, int) { count[offset + bond_sum]++; }
+};
+
+// adds the low block histogram for B shifted by bond_sum
+struct ShiftVisit
+{
+  const int *start;		// entries of B are start[B]..start[B+1]-1
+  const int *bonds;		// low block bond sum of an entry
+  const long long *number;	//  and its number of configurations
+  long long *count;		// count[offset + sign * total bond sum]
+  int offset;			// num_bonds
+  int sign;			// -J
+  void operator() (int bond_sum, int B)
+  {
+    for (int e = start[B]; e < start[B + 1]; e++)
+    {
+      count[offset + sign * (bond_sum + bonds[e])] += number[e];
+    }
+  }
+};
+
+//********************************************************************
+// Constructor for IsingEnumerator
+IsingEnumerator::IsingEnumerator (int Lx, int Ly, double J_in)
+{
+  num_sites = Lx * Ly;
+  if (Lx < 3 || Ly < 1 || Ly == 2 || num_sites > 62)
+  {
+    cerr << "IsingEnumerator: need Lx >= 3, Ly = 1 or >= 3, and at most "
+         << "62 sites" << endl;
+    exit (1);
+  }
+  J = (J_in < 0. ? -1. : 1.);
+  coordination = (Ly == 1 ? 2 : 4);
+  num_bonds = num_sites * coordination / 2;
+
+  // neighbours: left, right (and down, up) with periodic wrap-around
+  nearest_neighbor.resize (num_sites * coordination);
+  for (int j = 0; j < Ly; j++)
+  {
+    for (int i = 0; i < Lx; i++)
+    {
+      int *nb = &nearest_neighbor[(i + j * Lx) * coordination];
+      nb[0] = (i - 1 + Lx) % Lx + j * Lx;
+      nb[1] = (i + 1) % Lx + j * Lx;
+      if (coordination == 4)
+      {
+        nb[2] = i + (j - 1 + Ly) % Ly * Lx;
+        nb[3] = i + (j + 1) % Ly * Lx;
+      }
+    }
+  }
+
+  // the largest low block whose table takes at most 2^max_table_bits steps
+  for (num_low = num_sites; num_low > 1; num_low--)
+  {
+    find_boundary ();
+    if (num_low + int (boundary.size ()) <= max_table_bits)
+    {
+      break;
+    }
+  }
+  find_boundary ();
+}
+
+// sites outside the low block with a neighbour in it
+void
+IsingEnumerator::find_boundary ()
+{
+  boundary.clear ();
+  for (int k = num_low; k < num_sites; k++)
+  {
+    for (int n = 0; n < coordination; n++)
+    {
+      if (nearest_neighbor[k * coordination + n] < num_low)
+      {
+        boundary.push_back (k);
+        break;
+      }
+    }
+  }
+}
+
+//********************************************************************
+void
+IsingEnumerator::count_energies (long long energy_count[],
+                                 int num_threads) const
+{
+  int num_energies = get_num_energies ();
+  for (int i = 0; i < num_energies; i++)
+  {
+    energy_count[i] = 0;
+  }
+
+  const int *nb = &nearest_neighbor[0];
+  const int z = coordination;
+  int num_boundary = (int) boundary.size ();
+  int num_B = 1 << num_boundary;
+  int num_high = num_sites - num_low;
+
+  vector<int> bit (num_sites, 0);	// bit of B for each boundary site
+  for (int b = 0; b < num_boundary; b++)
+  {
+    bit[boundary[b]] = 1 << b;
+  }
+  vector<int> low_site (num_low), high_site (num_high);
+  for (int k = 0; k < num_low; k++)
+  {
+    low_site[k] = k;
+  }
+  for (int k = 0; k < num_high; k++)
+  {
+    high_site[k] = num_low + k;
+  }
+
+#ifdef _OPENMP
+  if (num_threads <= 0)
+  {
+    num_threads = omp_get_max_threads ();
+  }
+#else
+  (void) num_threads;		// always one thread
+#endif
+
+  // 1. table[B]: histogram of the sum over the bonds touching the low
+  //    block, for boundary configuration B (other spins set to 0)
+  vector<long long> table ((size_t) num_B * num_energies, 0);
+  int B;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1) num_threads(num_threads)
+#endif
+  for (B = 0; B < num_B; B++)
+  {
+    int spin[64];
+    for (int k = 0; k < num_sites; k++)
+    {
+      spin[k] = (k < num_low ? -1 : 0);
+    }
+    for (int b = 0; b < num_boundary; b++)
+    {
+      spin[boundary[b]] = (((B >> b) & 1) ? +1 : -1);
+    }
+    int bond_sum = 0;		// low-low bonds are seen from both ends
+    for (int k = 0; k < num_low; k++)
+    {
+      for (int n = 0; n < z; n++)
+      {
+        int j = nb[k * z + n];
+        bond_sum += spin[k] * spin[j] * (j < num_low ? 1 : 2);
+      }
+    }
+    bond_sum /= 2;
+
+    HistogramVisit visit;
+    visit.count = &table[(size_t) B * num_energies];
+    visit.offset = num_bonds;
+    if (z == 2)
+    {
+      gray_walk<2> (spin, nb, &low_site[0], num_low, &bit[0], bond_sum, B,
+                    visit);
+    }
+    else
+    {
+      gray_walk<4> (spin, nb, &low_site[0], num_low, &bit[0], bond_sum, B,
+                    visit);
+    }
+  }
+
+  // keep only the nonzero entries of each table[B]
+  vector<int> start (num_B + 1, 0);
+  vector<int> bonds;
+  vector<long long> number;
+  for (B = 0; B < num_B; B++)
+  {
+    start[B] = (int) bonds.size ();
+    for (int i = 0; i < num_energies; i++)
+    {
+      if (table[(size_t) B * num_energies + i] != 0)
+      {
+        bonds.push_back (i - num_bonds);
+        number.push_back (table[(size_t) B * num_energies + i]);
+      }
+    }
+  }
+  start[num_B] = (int) bonds.size ();
+
+  // 2. walk over the other sites, split into prefixes of the top bits
+  int prefix_bits = num_high - 12;	// at least 2^12 steps per walk
+  prefix_bits = (prefix_bits < 0 ? 0 : prefix_bits);
+  prefix_bits = (prefix_bits > max_prefix_bits ? max_prefix_bits
+                 : prefix_bits);
+  int num_free = num_high - prefix_bits;
+  long long num_prefixes = 1LL << prefix_bits;
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(num_threads)
+#endif
+  {
+    vector<long long> count (num_energies, 0);	// this thread's histogram
+    long long prefix;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic,1)
+#endif
+    for (prefix = 0; prefix < num_prefixes; prefix++)
+    {
+      int spin[64];
+      int B0 = 0;
+      for (int k = 0; k < num_sites; k++)
+      {
+        int up = (k >= num_low + num_free
+                  && ((prefix >> (k - num_low - num_free)) & 1));
+        spin[k] = (k < num_low ? 0 : (up ? +1 : -1));
+        if (up)
+        {
+          B0 |= bit[k];
+        }
+      }
+      int bond_sum = 0;		// bonds with no end in the low block
+      for (int k = num_low; k < num_sites; k++)
+      {
+        for (int n = 0; n < z; n++)
+        {
+          bond_sum += spin[k] * spin[nb[k * z + n]];
+        }
+      }
+      bond_sum /= 2;
+
+      ShiftVisit visit;
+      visit.start = &start[0];
+      visit.bonds = &bonds[0];
+      visit.number = &number[0];
+      visit.count = &count[0];
+      visit.offset = num_bonds;
+      visit.sign = -int (J);
+      if (z == 2)
+      {
+        gray_walk<2> (spin, nb, &high_site[0], num_free, &bit[0], bond_sum,
+                      B0, visit);
+      }
+      else
+      {
+        gray_walk<4> (spin, nb, &high_site[0], num_free, &bit[0], bond_sum,
+                      B0, visit);
+      }
+    }
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+    for (int i = 0; i < num_energies; i++)
+    {
+      energy_count[i] += count[i];
+    }
+  }
+}
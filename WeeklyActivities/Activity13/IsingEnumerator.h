@@ -0,0 +1,58 @@
+//  file: IsingEnumerator.h
+//
+//  Header file for the IsingEnumerator class: exact density of states
+//   (number of configurations at each energy) of a small periodic Ising
+//   chain or square lattice, by visiting all 2^num_sites configurations
+//   in Gray-code order.
+//
+//  Revision history:
+//      25-May-2021  original version, replaces next_configuration() in
+//                    sampling_test.cpp
+//
+//  Notes:
+//   * in Gray-code order consecutive configurations differ by one spin,
+//      so the energy changes by -2 J s h (h = sum of its neighbours) and
+//      each configuration costs O(1) instead of an O(N) calculate_energy.
+//   * energy_count[i] is the number of configurations with energy
+//      E = i - num_bonds (in units of |J|), the convention of
+//      sampling_test.cpp (num_bonds = num_sites for a chain) and
+//      ising_opt.cpp (num_bonds = 2 * num_sites on a square lattice).
+//   * the low sites are summed over in bulk (see IsingEnumerator.cpp),
+//      so a ring of 40 spins or a 6 x 6 lattice takes seconds, not hours.
+//   * the walks are split by the top bits of the configuration into
+//      separate Gray-code walks, so the work spreads over OpenMP threads.
+//
+#ifndef ISING_ENUMERATOR_H
+#define ISING_ENUMERATOR_H
+
+#include <vector>
+
+class IsingEnumerator
+{
+public:
+  // Lx sites in a ring if Ly = 1, otherwise an Lx x Ly lattice with
+  //  periodic boundary conditions; site id = i + j*Lx as in ising_opt
+  IsingEnumerator (int Lx, int Ly = 1, double J = 1.);
+
+  int get_num_sites () const { return num_sites; };
+  int get_num_bonds () const { return num_bonds; };
+  int get_num_energies () const { return 2 * num_bonds + 1; };
+  double energy_i (int i) const { return double (i - num_bonds); };
+
+  // fill energy_count[0..num_energies-1]; num_threads = 0 means all
+  void count_energies (long long energy_count[], int num_threads = 0) const;
+
+private:
+  void find_boundary ();	// boundary of the low block
+
+  int num_sites;		// number of spins (at most 62)
+  int num_bonds;		// number of bonds
+  double J;			// coupling, +1 or -1
+  int coordination;		// neighbours per site, 2 or 4
+  std::vector<int> nearest_neighbor;	// [id*coordination + k]
+
+  int num_low;			// sites 0..num_low-1 are summed in bulk
+  std::vector<int> boundary;	// other sites with a neighbour among them
+};
+
+#endif
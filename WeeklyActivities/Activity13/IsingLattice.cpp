@@ -0,0 +1,87 @@
+//  file: IsingLattice.cpp
+//
+//  Member functions for the IsingLattice class (neighbour table for 1,
+//   2 and 3 dimensional Ising lattices).
+//
+//  Revision history:
+//      26-May-2021  original version
+//
+//  Notes:
+//   * with periodic boundaries L must be at least 3, otherwise the two
+//      neighbours in a direction are the same site.
+//
+//******************************************************************
+
+// include files
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+#include "IsingLattice.h"
+
+//********************************************************************
+// Constructor for IsingLattice
+IsingLattice::IsingLattice (int dimension_in, int linear_sites_in,
+                            bool periodic, double J_in)
+{
+  dimension = dimension_in;
+  linear_sites = linear_sites_in;
+  J = J_in;
+  if (dimension < 1 || dimension > 3 || linear_sites < (periodic ? 3 : 1))
+  {
+    cerr << "IsingLattice: need dimension 1, 2 or 3 and L >= 3 "
+         << "(L >= 1 for free boundaries)" << endl;
+    exit (1);
+  }
+
+  int L = linear_sites;
+  num_sites = 1;
+  for (int d = 0; d < dimension; d++)
+  {
+    num_sites *= L;
+  }
+  max_nb = 2 * dimension;
+  nearest.assign (num_sites * max_nb, 0);
+  count.assign (num_sites, 0);
+
+  int num_ends = 0;		// every bond has two ends
+  for (int id = 0; id < num_sites; id++)
+  {
+    int stride = 1;		// 1, L, L*L for x, y, z
+    for (int d = 0; d < dimension; d++)
+    {
+      int x = (id / stride) % L;	// coordinate in direction d
+      int base = id - x * stride;
+      for (int step = -1; step <= 1; step += 2)
+      {
+        int x_nb = x + step;
+        if (x_nb < 0 || x_nb >= L)
+        {
+          if (!periodic)
+          {
+            continue;		// no neighbour past a free boundary
+          }
+          x_nb = (x_nb + L) % L;
+        }
+        nearest[id * max_nb + count[id]] = base + x_nb * stride;
+        count[id]++;
+        num_ends++;
+      }
+      stride *= L;
+    }
+  }
+  num_bonds = num_ends / 2;
+}
+
+//********************************************************************
+// E = -J sum over bonds of s_i s_j; each bond is seen from both ends
+double
+IsingLattice::energy (const int config[]) const
+{
+  long long sum = 0;
+  for (int id = 0; id < num_sites; id++)
+  {
+    sum += config[id] * local_field (config, id);
+  }
+  return (-J * double (sum / 2));
+}
@@ -0,0 +1,67 @@
+//  file: IsingLattice.h
+//
+//  Header file for the IsingLattice class: the neighbour topology of a
+//   hypercubic Ising lattice in 1, 2 or 3 dimensions, with periodic or
+//   free boundary conditions, built once so the energy change of a
+//   single spin flip is O(1).
+//
+//  Revision history:
+//      26-May-2021  original version, shared by sampling_test.cpp,
+//                    ising_model.cpp and ising_opt.cpp
+//
+//  Notes:
+//   * site id = i + j*L + k*L*L as in ising_opt.cpp; the neighbours of
+//      a site are listed in the order -x, +x, -y, +y, -z, +z (left,
+//      right, down, up, ...), skipping those outside a free boundary.
+//   * the spins are the int arrays the programs already use, +1 or -1.
+//   * flipping spin s with local field h (the sum of its neighbours)
+//      changes the energy by delta_E = 2 J s h.
+//
+#ifndef ISING_LATTICE_H
+#define ISING_LATTICE_H
+
+#include <vector>
+
+class IsingLattice
+{
+public:
+  // linear_sites^dimension sites; periodic = false gives free boundaries
+  IsingLattice (int dimension, int linear_sites, bool periodic = true,
+                double J = 1.);
+
+  int get_dimension () const { return dimension; };
+  int get_num_sites () const { return num_sites; };
+  int get_num_bonds () const { return num_bonds; };
+  int num_neighbors (int id) const { return count[id]; };
+  int neighbor (int id, int k) const { return nearest[id * max_nb + k]; };
+
+  // sum of the spins next to site id
+  int local_field (const int config[], int id) const
+  {
+    const int *nb = &nearest[id * max_nb];
+    int h = 0;
+    for (int k = 0; k < count[id]; k++)
+    {
+      h += config[nb[k]];
+    }
+    return (h);
+  };
+  // energy change if spin id is flipped
+  double delta_energy (const int config[], int id) const
+  {
+    return (2. * J * double (config[id] * local_field (config, id)));
+  };
+  double energy (const int config[]) const;	// from scratch, O(N)
+
+private:
+  int dimension;		// 1, 2 or 3
+  int linear_sites;		// L
+  int num_sites;		// L^dimension
+  int num_bonds;		// number of distinct bonds
+  int max_nb;			// 2*dimension
+  double J;			// coupling (the "J" in the Ising model)
+  std::vector<int> nearest;	// neighbours of id at [id*max_nb + k]
+  std::vector<int> count;	// number of neighbours of each site
+};
+
+#endif
@@ -0,0 +1,319 @@
+//  file: IsingPacked.cpp
+//
+//  Member functions for the IsingPacked class (multi-spin coded
+//   checkerboard Metropolis for the two-dimensional Ising model).
+//
+//  Revision history:
+//      21-May-2021  original version
+//
+//  Notes:
+//   * for a word s of spins the neighbour words are
+//        left  = (s << 1) | (bit 63 of the word to the left)
+//        right = (s >> 1) | (bit 0 of the word to the right) << 63
+//        down, up = the same word in rows j-1 and j+1
+//      and x_k = s ^ neighbour_k marks the anti-aligned bonds.  A bit-sliced
+//      adder turns x_1..x_4 into the count a = 0..4 for all 64 sites at
+//      once, and a site with a anti-aligned neighbours has
+//      delta_E = 2 J (4 - 2a), so the class of every move comes from
+//      bit logic instead of a table lookup per site.
+//   * a move that is accepted with probability p < 1 needs an
+//      independent random bit with P(1) = p for each site.  These are
+//      made 64 at a time by comparing uniform random numbers U with p
+//      one binary digit at a time, from the most significant down: a
+//      site is decided at the first digit where U and p differ, so each
+//      random word settles about half of the sites still open, and ~7
+//      words decide all 64.  Only the sites that need a decision are
+//      followed, p is used to its full 64 bits, and the (at most two)
+//      classes with p < 1 share the random words.
+//   * only the sites of one color change in a half-sweep, and bit 63 of
+//      the word to the left (and bit 0 to the right) always has the other
+//      color, so words can be updated in place.
+//
+//******************************************************************
+
+// include files
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+using namespace std;
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "IsingPacked.h"
+
+//********************************************************************
+// SplitMix64 finalizer, used to derive seeds and as the random stream
+static inline uint64_t
+mix64 (uint64_t z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return (z ^ (z >> 31));
+}
+
+// number of bits set in x (SWAR count: no popcnt instruction needed)
+static inline int
+count_bits (uint64_t x)
+{
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return (int ((x * 0x0101010101010101ULL) >> 56));
+}
+
+const int max_strips = 64;	// strips of rows (and rng streams) per lattice
+const int rng_stride = 8;	// one 64-byte cache line per stream
+const uint64_t even_bits = 0x5555555555555555ULL;	// bits 0, 2, 4, ...
+
+//********************************************************************
+// Constructor for IsingPacked
+IsingPacked::IsingPacked (int L_in, double kT_in, unsigned long long seed,
+                          double J_in)
+{
+  if (L_in < 64 || L_in % 64 != 0)
+  {
+    cerr << "IsingPacked: L = " << L_in << " must be a multiple of 64"
+         << endl;
+    exit (1);
+  }
+  L = L_in;
+  words = L / 64;
+  num_sites = (long long) L * L;
+  J = J_in;
+  threads = 0;
+  config.assign ((size_t) L * words, 0);
+
+  num_strips = (L / 2 < max_strips ? L / 2 : max_strips);
+  strip_row.resize (num_strips + 1);
+  for (int s = 0; s <= num_strips; s++)
+  {
+    strip_row[s] = int ((long long) s * L / num_strips);
+  }
+  rng_state.assign (num_strips * rng_stride, 0);
+  uint64_t key = mix64 (seed);
+  for (int s = 0; s < num_strips; s++)
+  {
+    rng_state[s * rng_stride] = mix64 (key + (s + 1) * 0x9e3779b97f4a7c15ULL);
+  }
+
+  set_kT (kT_in);
+  randomize ();
+}
+
+//********************************************************************
+void
+IsingPacked::set_kT (double kT_in)
+{
+  kT = kT_in;
+  for (int a = 0; a <= 4; a++)
+  {
+    double delta_energy = 2. * J * double (4 - 2 * a);
+    double p = (delta_energy <= 0. ? 1. : exp (-delta_energy / kT));
+    always[a] = (p >= 1.);
+    // p * 2^64, rounded down; p < 1 so this fits in 64 bits
+    threshold[a] = (always[a] ? 0 : (uint64_t) ldexp (p, 64));
+  }
+}
+
+void
+IsingPacked::randomize ()
+{
+  for (int s = 0; s < num_strips; s++)
+  {
+    for (size_t w = (size_t) strip_row[s] * words;
+         w < (size_t) strip_row[s + 1] * words; w++)
+    {
+      config[w] = next_random (s);
+    }
+  }
+  bond_sum = count_bonds ();
+}
+
+void
+IsingPacked::set_all (int spin_value)
+{
+  for (size_t w = 0; w < config.size (); w++)
+  {
+    config[w] = (spin_value < 0 ? 0 : ~0ULL);
+  }
+  bond_sum = 2LL * num_sites;
+}
+
+int
+IsingPacked::spin (int i, int j) const
+{
+  uint64_t word = config[(size_t) j * words + i / 64];
+  return (((word >> (i % 64)) & 1) ? +1 : -1);
+}
+
+long long
+IsingPacked::magnetization () const
+{
+  long long up = 0;
+  for (size_t w = 0; w < config.size (); w++)
+  {
+    up += count_bits (config[w]);
+  }
+  return (2 * up - num_sites);
+}
+
+double
+IsingPacked::calculate_energy () const
+{
+  return (-J * double (count_bonds ()));
+}
+
+// bonds to the right and upward neighbours, periodic in both directions:
+//  each anti-aligned bond counts -1 and each aligned bond +1
+long long
+IsingPacked::count_bonds () const
+{
+  long long anti = 0;
+  for (int j = 0; j < L; j++)
+  {
+    const uint64_t *row = &config[(size_t) j * words];
+    const uint64_t *up = &config[(size_t) ((j + 1) % L) * words];
+    for (int w = 0; w < words; w++)
+    {
+      uint64_t next = row[w + 1 < words ? w + 1 : 0];
+      uint64_t right = (row[w] >> 1) | (next << 63);
+      anti += count_bits (row[w] ^ right) + count_bits (row[w] ^ up[w]);
+    }
+  }
+  return (2 * num_sites - 2 * anti);
+}
+
+//********************************************************************
+// next 64 random bits of a SplitMix64 stream
+static inline uint64_t
+next_bits (uint64_t &state)
+{
+  state += 0x9e3779b97f4a7c15ULL;
+  return (mix64 (state));
+}
+
+uint64_t
+IsingPacked::next_random (int strip)
+{
+  return (next_bits (rng_state[strip * rng_stride]));
+}
+
+// Accept/reject for the sites that need a random decision: the bits of
+//  open1 and open2 (disjoint) are set in the result independently with
+//  probabilities p1 = thresh1 / 2^64 and p2 = thresh2 / 2^64.  Since the
+//  sets do not overlap, one random word supplies the next digit of U for
+//  both of them.
+static inline uint64_t
+bernoulli_mask (uint64_t &state, uint64_t thresh1, uint64_t open1,
+                uint64_t thresh2, uint64_t open2)
+{
+  uint64_t result = 0;
+
+  // two digits per pass: the two random words do not depend on each
+  //  other, so their latencies overlap
+  for (int digit = 63; digit >= 0 && (open1 | open2) != 0; digit -= 2)
+  {
+    uint64_t u[2];
+    u[0] = next_bits (state);
+    u[1] = next_bits (state);
+    for (int k = 0; k < 2; k++)
+    {
+      // all ones if this digit of p is 1: then sites with U digit 0 have
+      //  U < p (accept), otherwise sites with U digit 1 have U > p (reject)
+      uint64_t p1_digit = 0 - ((thresh1 >> (digit - k)) & 1);
+      uint64_t p2_digit = 0 - ((thresh2 >> (digit - k)) & 1);
+      result |= ((open1 & p1_digit) | (open2 & p2_digit)) & ~u[k];
+      open1 &= ~(u[k] ^ p1_digit);	// still open where the digits agree
+      open2 &= ~(u[k] ^ p2_digit);
+    }
+  }
+  return (result);		// sites still open have U >= p: reject
+}
+
+// Metropolis update of the sites of one color in one strip
+long long
+IsingPacked::half_sweep (int color, int strip)
+{
+  long long delta_bonds = 0;
+
+  // delta_E = 2 J (4 - 2a) > 0, so p < 1, for at most two classes:
+  //  a = 0, 1 if J > 0 and a = 4, 3 if J < 0
+  int c1 = (J > 0. ? 0 : 4);
+  int c2 = (J > 0. ? 1 : 3);
+  uint64_t need1 = (always[c1] ? 0 : ~0ULL);	// all ones if p < 1
+  uint64_t need2 = (always[c2] ? 0 : ~0ULL);
+  uint64_t thresh1 = threshold[c1];	// local copies: stores into the
+  uint64_t thresh2 = threshold[c2];	//  lattice could alias the members
+  uint64_t state = rng_state[strip * rng_stride];
+
+  for (int j = strip_row[strip]; j < strip_row[strip + 1]; j++)
+  {
+    uint64_t *row = &config[(size_t) j * words];
+    const uint64_t *down = &config[(size_t) ((j - 1 + L) % L) * words];
+    const uint64_t *up = &config[(size_t) ((j + 1) % L) * words];
+    uint64_t mine = (((color + j) & 1) ? ~even_bits : even_bits);
+
+    for (int w = 0; w < words; w++)
+    {
+      uint64_t s = row[w];
+      uint64_t prev = row[w > 0 ? w - 1 : words - 1];
+      uint64_t next = row[w + 1 < words ? w + 1 : 0];
+
+      // anti-aligned bonds to left, right, down, up
+      uint64_t x1 = s ^ ((s << 1) | (prev >> 63));
+      uint64_t x2 = s ^ ((s >> 1) | (next << 63));
+      uint64_t x3 = s ^ down[w];
+      uint64_t x4 = s ^ up[w];
+
+      // a = x1 + x2 + x3 + x4 as three bit planes b2 b1 b0
+      uint64_t s12 = x1 ^ x2, c12 = x1 & x2;
+      uint64_t s34 = x3 ^ x4, c34 = x3 & x4;
+      uint64_t b0 = s12 ^ s34;
+      uint64_t carry = s12 & s34;
+      uint64_t b1 = c12 ^ c34 ^ carry;
+      uint64_t b2 = c12 & c34;
+
+      uint64_t eq[5];
+      eq[0] = ~b2 & ~b1 & ~b0;
+      eq[1] = ~b2 & ~b1 & b0;
+      eq[2] = ~b2 & b1 & ~b0;
+      eq[3] = ~b2 & b1 & b0;
+      eq[4] = b2;
+
+      // every other class is always accepted
+      uint64_t open1 = eq[c1] & mine & need1;
+      uint64_t open2 = eq[c2] & mine & need2;
+      uint64_t flip = mine & ~(open1 | open2);
+      flip |= bernoulli_mask (state, thresh1, open1, thresh2, open2);
+
+      row[w] = s ^ flip;
+      // flipping a site with a anti-aligned bonds changes bond_sum by 4a - 8
+      delta_bonds += 4LL * (count_bits (flip & b0) + 2 * count_bits (flip & b1)
+                            + 4 * count_bits (flip & b2))
+                     - 8LL * count_bits (flip);
+    }
+  }
+  rng_state[strip * rng_stride] = state;
+  return (delta_bonds);
+}
+
+void
+IsingPacked::sweep ()
+{
+  for (int color = 0; color < 2; color++)
+  {
+    long long delta_bonds = 0;
+    int s;
+#ifdef _OPENMP
+    int num_threads = (threads > 0 ? threads : omp_get_max_threads ());
+#pragma omp parallel for schedule(static) reduction(+:delta_bonds) num_threads(num_threads)
+#endif
+    for (s = 0; s < num_strips; s++)
+    {
+      delta_bonds += half_sweep (color, s);
+    }
+    bond_sum += delta_bonds;
+  }
+}
@@ -0,0 +1,75 @@
+//  file: IsingPacked.h
+//
+//  Header file for the IsingPacked class: the two-dimensional Ising model
+//   with multi-spin coding, 64 spins per 64-bit word.  Same lattice,
+//   checkerboard Metropolis sweep and strip/rng layout as IsingEngine,
+//   but 1 bit per site instead of 1 byte, and each word of 64 spins is
+//   updated with a handful of bitwise operations.
+//
+//  Revision history:
+//      21-May-2021  original version
+//
+//  Notes:
+//   * bit k of word w in row j is the spin at i = 64*w + k (1 = up,
+//      0 = down), so L must be a multiple of 64.  A 65536 x 65536
+//      lattice takes 512 MB.
+//   * random bits come from one SplitMix64 stream per strip (64 bits a
+//      call, much cheaper than gsl_rng_uniform() per site).
+//
+#ifndef ISING_PACKED_H
+#define ISING_PACKED_H
+
+#include <vector>
+#include <stdint.h>
+
+class IsingPacked
+{
+public:
+  // L x L lattice (L a multiple of 64) at temperature kT, random start
+  IsingPacked (int L, double kT, unsigned long long seed, double J = 1.);
+
+  void set_kT (double kT);	// new temperature, same configuration
+  void set_threads (int num_threads) { threads = num_threads; };	// 0 = all
+  void randomize ();		// hot start
+  void set_all (int spin);	// cold start: every spin = spin
+
+  void sweep ();		// one mcs: red half-sweep, then black
+
+  int get_L () const { return L; };
+  long long get_num_sites () const { return num_sites; };
+  double get_kT () const { return kT; };
+  int spin (int i, int j) const;	// +1 or -1
+
+  double energy () const { return -J * double (bond_sum); };	// tracked
+  long long magnetization () const;	// sum of the spins, O(N/64)
+  double calculate_energy () const;	// from scratch, for checks
+
+  int get_num_strips () const { return num_strips; };
+
+private:
+  long long count_bonds () const;	// sum over bonds of s_i s_j
+  long long half_sweep (int color, int strip);	// returns change in bond_sum
+  uint64_t next_random (int strip);	// 64 random bits from a strip stream
+
+  int L;			// linear size
+  int words;			// 64-bit words per row, L/64
+  long long num_sites;		// L*L
+  double kT;			// temperature (in energy units)
+  double J;			// coupling
+  int threads;			// OpenMP threads for sweep(), 0 = all
+
+  std::vector<uint64_t> config;	// spin bits, row j at config[j*words]
+  long long bond_sum;		// sum over bonds of s_i s_j, E = -J*bond_sum
+
+  // acceptance for a site with a anti-aligned neighbours (a = 0..4):
+  //  always[a] is true if the move is always accepted, otherwise it is
+  //  accepted with probability threshold[a] / 2^64
+  bool always[5];
+  uint64_t threshold[5];
+
+  int num_strips;		// number of strips of rows
+  std::vector<int> strip_row;	// strip s has rows strip_row[s]..strip_row[s+1]-1
+  std::vector<uint64_t> rng_state;	// SplitMix64 state, one per strip
+};
+
+#endif
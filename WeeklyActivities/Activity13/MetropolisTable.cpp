@@ -0,0 +1,58 @@
+//  file: MetropolisTable.cpp
+//
+//  Member functions for the MetropolisTable class (integer thresholds
+//   for Metropolis acceptance in the Ising model).
+//
+//  Revision history:
+//      22-May-2021  original version
+//
+//  Notes:
+//   * scale = 2^32 is a power of two, so probability(sh) * scale is
+//      exact and the only rounding is the ceil().
+//
+//******************************************************************
+
+// include files
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+using namespace std;
+
+#include "MetropolisTable.h"
+
+//********************************************************************
+// Constructor for MetropolisTable
+MetropolisTable::MetropolisTable (const gsl_rng *rng, double kT_in,
+                                  double J_in, int max_sh_in)
+{
+  if (gsl_rng_min (rng) != 0)
+  {
+    cerr << "MetropolisTable: the rng must have gsl_rng_min = 0" << endl;
+    exit (1);
+  }
+  J = J_in;
+  max_sh = max_sh_in;
+  scale = double (gsl_rng_max (rng)) + 1.;
+  threshold.resize (2 * max_sh + 1);
+
+  set_kT (kT_in);
+}
+
+//********************************************************************
+void
+MetropolisTable::set_kT (double kT_in)
+{
+  kT = kT_in;
+  for (int sh = -max_sh; sh <= max_sh; sh++)
+  {
+    threshold[sh + max_sh] = (unsigned long long) ceil (probability (sh)
+                                                          * scale);
+  }
+}
+
+double
+MetropolisTable::probability (int sh) const
+{
+  double delta_energy = 2. * J * double (sh);
+  return (delta_energy <= 0. ? 1. : exp (-delta_energy / kT));
+}
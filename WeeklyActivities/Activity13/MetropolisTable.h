@@ -0,0 +1,67 @@
+//  file: MetropolisTable.h
+//
+//  Header file for the MetropolisTable class: the Metropolis acceptance
+//   probabilities min(1, exp(-delta_E/kT)) for an Ising spin flip,
+//   precomputed once per temperature as integer thresholds on the raw
+//   output of a GSL random number generator.
+//
+//  Revision history:
+//      22-May-2021  original version
+//      06-Jun-2021  notes on xoshiro_type
+//
+//  Notes:
+//   * flipping spin s with neighbor sum h changes the energy by
+//      delta_E = 2 J s h, and s*h takes only the integer values
+//      -max_sh..max_sh (max_sh = 2*dimension, the number of neighbors).
+//   * the move is accepted if gsl_rng_get(rng) < threshold, which is
+//      p = min(1, exp(-delta_E/kT)) rounded up to a multiple of
+//      1/(gsl_rng_max + 1), so the hot loop has no exp() and no
+//      conversion to double.  For generators like taus and mt19937,
+//      whose uniform deviate is gsl_rng_get / (max + 1), it is exactly
+//      the test gsl_rng_uniform(rng) < p and gives the same chain as the
+//      test in double.  For RngStreams::xoshiro_type (the RngStreams
+//      default) gsl_rng_get is the top 32 bits of a number and
+//      gsl_rng_uniform uses 53 bits of a different number, so the
+//      chain differs from the double test, with the same acceptance
+//      probabilities to within 2^-32.
+//   * the generator must have gsl_rng_min = 0.
+//
+#ifndef METROPOLIS_TABLE_H
+#define METROPOLIS_TABLE_H
+
+#include <vector>
+
+#include <gsl/gsl_rng.h>	// GSL random number generators
+
+class MetropolisTable
+{
+public:
+  // acceptance for s*h = -max_sh..max_sh at temperature kT, with
+  //  thresholds scaled to the output range of rng
+  MetropolisTable (const gsl_rng *rng, double kT, double J = 1.,
+                   int max_sh = 4);
+
+  void set_kT (double kT);	// recompute the thresholds
+  double get_kT () const { return kT; };
+
+  // true if the flip with s*h = sh is accepted, given random_bits from
+  //  gsl_rng_get
+  bool accept (unsigned long int random_bits, int sh) const
+  {
+    return (random_bits < threshold[sh + max_sh]);
+  };
+
+  double probability (int sh) const;	// min(1, exp(-2 J sh / kT))
+
+private:
+  double kT;			// temperature (in energy units)
+  double J;			// coupling (the "J" in the Ising model)
+  int max_sh;			// largest |s*h|
+  double scale;			// gsl_rng_max + 1 (= 2^32 for taus)
+
+  // threshold[sh + max_sh] = ceil(probability(sh) * scale), so that
+  //  random_bits < threshold exactly when random_bits / scale < p
+  std::vector<unsigned long long> threshold;
+};
+
+#endif
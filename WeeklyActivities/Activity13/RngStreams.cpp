@@ -0,0 +1,217 @@
+//  file: RngStreams.cpp
+//
+//  Static members of the RngStreams class: the master seed and the
+//   GSL random number streams derived from it
+//
+//  Revision history:
+//      06/01/21  original version (/dev/urandom code from random_seed.cpp)
+//      06/06/21  xoshiro256+ generator type, so streams cannot collide
+//      06/07/21  std::mutex and std::atomic instead of OpenMP pragmas
+//
+//  Notes:
+//   * init() and the first call of master_seed() may come from any
+//      thread, so they take a std::mutex; next_stream() is a std::atomic
+//      counter.  There is no OpenMP in this file: the object files are
+//      shared by all the makefiles of a directory, and RngStreams.o made
+//      with -fopenmp would not link into a program made without it.
+//   * the stream seeds use the SplitMix64 mixing function (Steele,
+//      Lea and Flood), applied to the master seed and then to the stream
+//      number added in, so that neighboring streams are unrelated.
+//   * the xoshiro256+ state is filled from the seed with SplitMix64, as
+//      in BulkRng; the four words are mix64 of seed + k*golden, which
+//      are never all zero, and s[0] alone already differs for any two
+//      seeds.
+//
+//******************************************************************
+
+// include files
+#include <iostream>		// cout and cin
+#include <fstream>		// file input and output
+#include <cstdlib>		// getenv and strtoul
+using namespace std;		// we need this when .h is omitted
+
+#include <mutex>
+
+#include <sys/time.h>		// for the fallback seed
+
+#include "RngStreams.h"
+
+std::atomic<bool> RngStreams::initialized (false);
+unsigned long int RngStreams::master = 0;
+std::atomic<unsigned long long> RngStreams::stream_counter (0);
+
+static std::mutex master_mutex;	// for init() and the first master_seed()
+
+// SplitMix64 finalizer
+static inline unsigned long long
+mix64 (unsigned long long z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return (z ^ (z >> 31));
+}
+
+//********************************************************************
+// xoshiro256+ as a GSL generator type
+struct XoshiroState
+{
+  unsigned long long s[4];
+};
+
+static inline unsigned long long
+rotl (unsigned long long x, int k)
+{
+  return ((x << k) | (x >> (64 - k)));
+}
+
+static inline unsigned long long
+xoshiro_next (void *vstate)
+{
+  unsigned long long *s = ((XoshiroState *) vstate)->s;
+  unsigned long long result = s[0] + s[3];
+  unsigned long long t = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl (s[3], 45);
+  return (result);
+}
+
+static void
+xoshiro_set (void *vstate, unsigned long int seed)
+{
+  unsigned long long *s = ((XoshiroState *) vstate)->s;
+  for (int k = 0; k < 4; k++)
+  {
+    s[k] = mix64 (seed + (k + 1) * 0x9e3779b97f4a7c15ULL);
+  }
+}
+
+static unsigned long int
+xoshiro_get (void *vstate)
+{
+  return ((unsigned long int) (xoshiro_next (vstate) >> 32));
+}
+
+static double
+xoshiro_get_double (void *vstate)
+{
+  return ((xoshiro_next (vstate) >> 11) * (1. / 9007199254740992.));	// 2^-53
+}
+
+static const gsl_rng_type xoshiro_gsl_type = {
+  "xoshiro256+", 0xffffffffUL, 0, sizeof (XoshiroState),
+  &xoshiro_set, &xoshiro_get, &xoshiro_get_double
+};
+
+const gsl_rng_type *RngStreams::xoshiro_type = &xoshiro_gsl_type;
+
+// the generator of the calling thread, freed when the thread ends
+struct ThreadRng
+{
+  gsl_rng *rng_ptr;
+  ThreadRng () : rng_ptr (0) { };
+  ~ThreadRng () { if (rng_ptr) gsl_rng_free (rng_ptr); };
+};
+static thread_local ThreadRng thread_generator;
+
+//********************************************************************
+// Set the master seed; 0 means from RNG_SEED, or else /dev/urandom
+void
+RngStreams::init (unsigned long int seed)
+{
+  lock_guard<mutex> lock (master_mutex);
+  set_master (seed);
+}
+
+unsigned long int
+RngStreams::master_seed ()
+{
+  if (!initialized.load (memory_order_acquire))
+  {
+    lock_guard<mutex> lock (master_mutex);
+    if (!initialized.load (memory_order_relaxed))
+    {
+      set_master (0);
+    }
+  }
+  return (master);
+}
+
+// The body of init(), called with master_mutex held
+void
+RngStreams::set_master (unsigned long int seed)
+{
+  const char *env_seed = getenv ("RNG_SEED");
+  if (seed == 0 && env_seed != 0)
+  {
+    seed = strtoul (env_seed, 0, 10);
+  }
+  if (seed == 0)
+  {
+    // open a stream to read from /dev/urandom as binary
+    ifstream dev_urandom ("/dev/urandom", ios::in | ios::binary);
+    if (dev_urandom.good ())
+    {
+      dev_urandom.read ((char *) &seed, sizeof (seed));
+    }
+    dev_urandom.close ();
+  }
+  if (seed == 0)
+  {				// no /dev/urandom: use the time instead
+    struct timeval tv;
+    gettimeofday (&tv, 0);
+    seed = tv.tv_sec * 1000003UL + tv.tv_usec;
+  }
+  master = seed;
+  initialized.store (true, memory_order_release);
+  cout << " RNG master seed = " << master << " (set RNG_SEED=" << master
+       << " to repeat this run)" << endl;
+}
+
+//********************************************************************
+// Seed for stream number stream: different for every stream, since
+//  mix64 and adding (stream+1) times an odd number are one-to-one
+unsigned long int
+RngStreams::stream_seed (unsigned long long stream)
+{
+  unsigned long long key = mix64 (master_seed ());
+  return ((unsigned long int)
+          mix64 (key + (stream + 1) * 0x9e3779b97f4a7c15ULL));
+}
+
+gsl_rng *
+RngStreams::new_rng (unsigned long long stream, const gsl_rng_type *type)
+{
+  gsl_rng *rng_ptr = gsl_rng_alloc (type);	// allocate the rng
+  set_stream (rng_ptr, stream);	// seed the rng
+  return (rng_ptr);
+}
+
+// Restart rng_ptr at the beginning of stream number stream
+void
+RngStreams::set_stream (gsl_rng *rng_ptr, unsigned long long stream)
+{
+  gsl_rng_set (rng_ptr, stream_seed (stream));
+}
+
+// Stream numbers 0, 1, 2, ... in the order they are asked for
+unsigned long long
+RngStreams::next_stream ()
+{
+  return (stream_counter.fetch_add (1));
+}
+
+// The generator of the calling thread, made as stream
+//  thread_stream_base + thread on its first call (see thread_rng())
+gsl_rng *
+RngStreams::make_thread_rng (int thread)
+{
+  if (thread_generator.rng_ptr == 0)
+  {
+    thread_generator.rng_ptr = new_rng (thread_stream_base + thread);
+  }
+  return (thread_generator.rng_ptr);
+}
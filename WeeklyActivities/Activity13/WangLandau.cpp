@@ -0,0 +1,444 @@
+//  file: WangLandau.cpp
+//
+//  Member functions for the WangLandau class (density of states of a
+//   periodic Ising lattice by Wang-Landau sampling).
+//
+//  Revision history:
+//      28-May-2021  original version
+//      07-Jun-2021  windows joined over the whole overlap
+//
+//  Notes:
+//   * i = num_bonds - (sum over bonds of s_i s_j), so flipping spin s
+//      with local field h moves the walker from i to i + 2 s h.
+//   * the histogram is flat when every energy seen so far in the window
+//      has been visited at least flatness times the average number of
+//      visits in this stage.
+//   * a walker starts in the ground state (all spins up, i = 0) and
+//      flips spins that bring it closer to its window until it is in
+//      it; moves that would leave the window are rejected (and the
+//      current energy is counted again).
+//   * windows k and k+1 are joined by shifting ln g of window k+1 by
+//      the mean difference over all the energies of the overlap seen by
+//      both (the least-squares shift), and then blending linearly from
+//      window k to window k+1 across the overlap, so that the edges of
+//      each window, where its ln g is least accurate, count the least.
+//      (Joining at the single energy where the slopes agree best, as
+//      before, puts the whole error of that one point into the shift.)
+//   * seeds for the walkers come from one seed through SplitMix64, as in
+//      IsingEngine.cpp.
+//
+//******************************************************************
+
+// include files
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+using namespace std;
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "WangLandau.h"
+
+const double window_overlap = 1. / 3.;	// fraction shared by neighbours
+
+//********************************************************************
+// SplitMix64: a good 64-bit mixer, used to derive one seed per walker
+static inline unsigned long long
+mix64 (unsigned long long z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return (z ^ (z >> 31));
+}
+
+// how far energy index i is outside lo..hi
+static inline int
+distance (int i, int lo, int hi)
+{
+  return (i < lo ? lo - i : (i > hi ? i - hi : 0));
+}
+
+//********************************************************************
+// Constructor for WangLandau
+WangLandau::WangLandau (int dimension, int L, int num_windows_in,
+                        int walkers_per_window_in, unsigned long int seed)
+  : lattice (dimension, L, true, 1.)
+{
+  if (L < 4 || L % 2 != 0 || num_windows_in < 1 || walkers_per_window_in < 1)
+  {
+    cerr << "WangLandau: need L even and at least 4, and at least one "
+         << "window and walker" << endl;
+    exit (1);
+  }
+  num_bonds = lattice.get_num_bonds ();
+  num_windows = num_windows_in;
+  walkers_per_window = walkers_per_window_in;
+  flatness = 0.8;
+  final_ln_f = 1.e-6;
+  check_sweeps = 10;
+  threads = 0;
+  num_flips = 0;
+
+  // windows over i = 0..num_bonds (E <= 0), wide enough that a walker
+  //  can always move within one (a flip changes i by up to 4*dimension)
+  double width = num_bonds / (num_windows - (num_windows - 1)
+                              * window_overlap);
+  if (width < 16 * dimension)
+  {
+    cerr << "WangLandau: " << num_windows << " windows are too narrow for "
+         << "this lattice" << endl;
+    exit (1);
+  }
+  window.resize (num_windows);
+  for (int k = 0; k < num_windows; k++)
+  {
+    Window &win = window[k];
+    win.lo = int (k * width * (1. - window_overlap) + 0.5);
+    win.hi = (k == num_windows - 1 ? num_bonds : int (win.lo + width + 0.5));
+    win.ln_f = 1.;
+    win.one_over_t = false;
+    win.done = false;
+    win.steps = 0;
+    win.num_seen = 0;
+    win.ln_g.assign (win.hi - win.lo + 1, 0.);
+    win.visits.assign (win.hi - win.lo + 1, 0);
+    win.seen.assign (win.hi - win.lo + 1, 0);
+  }
+
+  int N = lattice.get_num_sites ();
+  walker.resize (num_windows * walkers_per_window);
+  unsigned long long key = mix64 (seed);
+  for (int w = 0; w < int (walker.size ()); w++)
+  {
+    walker[w].rng = gsl_rng_alloc (gsl_rng_taus);
+    unsigned long int walker_seed =
+      (unsigned long int) mix64 (key + (w + 1) * 0x9e3779b97f4a7c15ULL);
+    if (walker_seed == 0)
+    {
+      walker_seed = 1;		// taus treats 0 as "use the default seed"
+    }
+    gsl_rng_set (walker[w].rng, walker_seed);
+    walker[w].config.assign (N, 1);
+    walker[w].i = 0;
+  }
+}
+
+// Destructor for WangLandau
+WangLandau::~WangLandau ()
+{
+  for (int w = 0; w < int (walker.size ()); w++)
+  {
+    gsl_rng_free (walker[w].rng);
+  }
+}
+
+//********************************************************************
+// Start from the ground state and flip spins until inside the window
+void
+WangLandau::enter_window (Walker &w, const Window &win)
+{
+  int N = lattice.get_num_sites ();
+  int *config = &w.config[0];
+  while (distance (w.i, win.lo, win.hi) > 0)
+  {
+    int id = (int) gsl_rng_uniform_int (w.rng, N);
+    int i_new = w.i + 2 * config[id] * lattice.local_field (config, id);
+    if (distance (i_new, win.lo, win.hi) <= distance (w.i, win.lo, win.hi))
+    {
+      config[id] = -config[id];
+      w.i = i_new;
+    }
+  }
+  w.ln_g = win.ln_g;
+  w.visits.assign (win.hi - win.lo + 1, 0);
+}
+
+// num_steps Wang-Landau steps of one walker inside its window
+void
+WangLandau::walk (Walker &w, const Window &win, long long num_steps)
+{
+  int N = lattice.get_num_sites ();
+  int *config = &w.config[0];
+  double *ln_g = &w.ln_g[0];	// indexed by i - lo
+  long long *visits = &w.visits[0];
+  gsl_rng *rng = w.rng;
+  double ln_f = win.ln_f;
+  int top = win.hi - win.lo;
+  int i = w.i - win.lo;
+
+  for (long long step = 0; step < num_steps; step++)
+  {
+    int id = (int) gsl_rng_uniform_int (rng, N);
+    int i_new = i + 2 * config[id] * lattice.local_field (config, id);
+    if (i_new >= 0 && i_new <= top)
+    {
+      double ln_ratio = ln_g[i] - ln_g[i_new];	// ln [g(E_old)/g(E_new)]
+      if (ln_ratio >= 0. || gsl_rng_uniform (rng) < exp (ln_ratio))
+      {
+        config[id] = -config[id];
+        i = i_new;
+      }
+    }
+    ln_g[i] += ln_f;
+    visits[i]++;
+  }
+  w.i = i + win.lo;
+}
+
+// Add the changes of the walkers of window k to its ln g and histogram,
+//  and start them again from the merged ln g
+bool
+WangLandau::merge_walkers (int k)
+{
+  Window &win = window[k];
+  int size = win.hi - win.lo + 1;
+  vector<double> change (size, 0.);
+  for (int w = k * walkers_per_window; w < (k + 1) * walkers_per_window;
+       w++)
+  {
+    for (int j = 0; j < size; j++)
+    {
+      change[j] += walker[w].ln_g[j] - win.ln_g[j];
+      win.visits[j] += walker[w].visits[j];
+      if (walker[w].visits[j] > 0)
+      {
+        win.seen[j] = 1;
+      }
+    }
+  }
+  for (int j = 0; j < size; j++)
+  {
+    win.ln_g[j] += change[j];
+  }
+  for (int w = k * walkers_per_window; w < (k + 1) * walkers_per_window;
+       w++)
+  {
+    walker[w].ln_g = win.ln_g;
+    walker[w].visits.assign (size, 0);
+  }
+
+  // flat if every energy seen has at least flatness * the average
+  long long total = 0, least = -1;
+  win.num_seen = 0;
+  for (int j = 0; j < size; j++)
+  {
+    if (win.seen[j])
+    {
+      total += win.visits[j];
+      least = (least < 0 || win.visits[j] < least ? win.visits[j] : least);
+      win.num_seen++;
+    }
+  }
+  return (win.num_seen > 0 && least > 0
+          && double (least) >= flatness * double (total) / win.num_seen);
+}
+
+//********************************************************************
+void
+WangLandau::run ()
+{
+  int N = lattice.get_num_sites ();
+  int num_walkers = int (walker.size ());
+  for (int w = 0; w < num_walkers; w++)
+  {
+    enter_window (walker[w], window[w / walkers_per_window]);
+  }
+
+#ifdef _OPENMP
+  int num_threads = (threads > 0 ? threads : omp_get_max_threads ());
+#endif
+  long long num_steps = (long long) check_sweeps * N;
+  int num_active = num_windows;
+  while (num_active > 0)
+  {
+    int w;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1) num_threads(num_threads)
+#endif
+    for (w = 0; w < num_walkers; w++)
+    {
+      const Window &win = window[w / walkers_per_window];
+      if (!win.done)
+      {
+        walk (walker[w], win, num_steps);
+      }
+    }
+    num_flips += num_steps * num_active * walkers_per_window;
+
+    for (int k = 0; k < num_windows; k++)
+    {
+      Window &win = window[k];
+      if (win.done)
+      {
+        continue;
+      }
+      win.steps += num_steps * walkers_per_window;
+      bool flat = merge_walkers (k);
+      double one_over_t = double (win.num_seen) / double (win.steps);
+      if (!win.one_over_t && flat)
+      {
+        win.ln_f /= 2.;		// next stage
+        win.visits.assign (win.visits.size (), 0);
+        win.one_over_t = (win.ln_f < one_over_t);
+      }
+      if (win.one_over_t)
+      {
+        win.ln_f = one_over_t;
+      }
+      if (win.ln_f < final_ln_f)
+      {
+        win.done = true;
+        num_active--;
+      }
+    }
+  }
+  join_windows ();
+}
+
+// Join the windows into ln g for i = 0..num_bonds, mirror to E > 0 and
+//  normalize to 2^N configurations in all
+void
+WangLandau::join_windows ()
+{
+  vector<double> joined (num_bonds + 1, 0.);
+  vector<char> ok (num_bonds + 1, 0);
+  for (int j = window[0].lo; j <= window[0].hi; j++)
+  {
+    joined[j] = window[0].ln_g[j - window[0].lo];
+    ok[j] = window[0].seen[j - window[0].lo];
+  }
+
+  for (int k = 1; k < num_windows; k++)
+  {
+    const Window &win = window[k];
+    int top = window[k - 1].hi;
+    // the energies in the overlap seen by both windows
+    vector<int> common;
+    for (int j = win.lo; j <= top; j++)
+    {
+      if (ok[j] && win.seen[j - win.lo])
+      {
+        common.push_back (j);
+      }
+    }
+    if (common.empty ())
+    {
+      cerr << "WangLandau: windows " << k - 1 << " and " << k
+           << " have no energies in common" << endl;
+      exit (1);
+    }
+
+    // least-squares shift: the mean difference over the whole overlap
+    double shift = 0.;
+    for (size_t c = 0; c < common.size (); c++)
+    {
+      int j = common[c];
+      shift += (joined[j] - win.ln_g[j - win.lo]) / double (common.size ());
+    }
+
+    // blend linearly across the overlap, from window k-1 to window k
+    int first = common.front ();
+    int last = common.back ();
+    for (int j = first; j <= num_bonds; j++)
+    {
+      bool in_win = (j <= win.hi && win.seen[j - win.lo]);
+      double ln_g_win = (in_win ? win.ln_g[j - win.lo] + shift : 0.);
+      if (j <= last && ok[j] && in_win)
+      {
+        double weight = (last > first ? double (j - first)
+                         / double (last - first) : 1.);
+        joined[j] = (1. - weight) * joined[j] + weight * ln_g_win;
+      }
+      else if (j > last || !ok[j])
+      {
+        ok[j] = in_win;
+        joined[j] = ln_g_win;
+      }
+    }
+  }
+
+  // g(E) = g(-E) on a bipartite lattice
+  int num_energies = get_num_energies ();
+  ln_dos.assign (num_energies, 0.);
+  seen.assign (num_energies, 0);
+  for (int j = 0; j <= num_bonds; j++)
+  {
+    ln_dos[j] = ln_dos[2 * num_bonds - j] = joined[j];
+    seen[j] = seen[2 * num_bonds - j] = ok[j];
+  }
+
+  double ln_max = 0.;
+  bool first = true;
+  for (int i = 0; i < num_energies; i++)
+  {
+    if (seen[i] && (first || ln_dos[i] > ln_max))
+    {
+      ln_max = ln_dos[i];
+      first = false;
+    }
+  }
+  double sum = 0.;
+  for (int i = 0; i < num_energies; i++)
+  {
+    if (seen[i])
+    {
+      sum += exp (ln_dos[i] - ln_max);
+    }
+  }
+  double shift = lattice.get_num_sites () * log (2.) - (ln_max + log (sum));
+  for (int i = 0; i < num_energies; i++)
+  {
+    if (seen[i])
+    {
+      ln_dos[i] += shift;
+    }
+  }
+}
+
+//********************************************************************
+// Z = sum over E of g(E) exp(-E/kT), summed relative to the largest
+//  term so that nothing overflows
+void
+WangLandau::thermodynamics (double kT, double &ln_Z, double &energy,
+                            double &specific_heat) const
+{
+  int num_energies = get_num_energies ();
+  double ln_max = 0.;
+  bool first = true;
+  for (int i = 0; i < num_energies; i++)
+  {
+    double ln_term = ln_dos[i] - energy_i (i) / kT;
+    if (seen[i] && (first || ln_term > ln_max))
+    {
+      ln_max = ln_term;
+      first = false;
+    }
+  }
+
+  double Z = 0., sum_E = 0.;
+  for (int i = 0; i < num_energies; i++)
+  {
+    if (seen[i])
+    {
+      double weight = exp (ln_dos[i] - energy_i (i) / kT - ln_max);
+      Z += weight;
+      sum_E += weight * energy_i (i);
+    }
+  }
+  energy = sum_E / Z;
+
+  double sum_dE2 = 0.;		// second pass: <(E - <E>)^2>
+  for (int i = 0; i < num_energies; i++)
+  {
+    if (seen[i])
+    {
+      double weight = exp (ln_dos[i] - energy_i (i) / kT - ln_max);
+      double dE = energy_i (i) - energy;
+      sum_dE2 += weight * dE * dE;
+    }
+  }
+  ln_Z = ln_max + log (Z);
+  specific_heat = sum_dE2 / Z / (kT * kT);
+}
@@ -0,0 +1,116 @@
+//  file: WangLandau.h
+//
+//  Header file for the WangLandau class: the density of states g(E)
+//   (number of configurations at each energy, energy_count[] in
+//   sampling_test.cpp) of a periodic Ising lattice too large to
+//   enumerate, estimated by Wang-Landau sampling.  From one estimate of
+//   ln g(E), Z, <E> and C follow at any temperature.
+//
+//  Revision history:
+//      28-May-2021  original version
+//
+//  Notes:
+//   * the energy index is that of IsingEnumerator: i = 0..num_energies-1
+//      for E = i - num_bonds (J = 1), and ln_g(i) is normalized so that
+//      the sum of g over all energies is 2^num_sites.
+//   * a walker flips single spins, accepted with probability
+//      min(1, g(E_old)/g(E_new)), and each step multiplies g of the
+//      current energy by f (ln g += ln f).  When the histogram of visits
+//      is flat, ln f is halved and the histogram reset.  Halving alone
+//      leaves an error that stops shrinking, so once ln f drops below
+//      1/t (t = steps per energy level in the window) it is set to 1/t
+//      instead (Belardinelli and Pereyra), until it is below final_ln_f.
+//   * L must be even: the lattice is then bipartite, g(E) = g(-E), and
+//      only E <= 0 is sampled.  That range is split into num_windows
+//      overlapping energy windows, each sampled by its own walkers
+//      (random walks over a narrow window converge much faster), and the
+//      pieces are joined where their slopes agree.
+//   * the walkers_per_window walkers of a window each keep their own
+//      histogram and ln g changes between checks, so they can run in
+//      separate OpenMP threads; at every check these are merged into the
+//      window's ln g and histogram.  Every walker has its own gsl_rng
+//      stream, so a run depends only on the seed, not on the threads.
+//
+#ifndef WANG_LANDAU_H
+#define WANG_LANDAU_H
+
+#include <vector>
+
+#include <gsl/gsl_rng.h>	// GSL random number generators
+
+#include "IsingLattice.h"
+
+class WangLandau
+{
+public:
+  // L^dimension periodic lattice with L even
+  WangLandau (int dimension, int L, int num_windows,
+              int walkers_per_window, unsigned long int seed);
+  ~WangLandau ();
+
+  void set_flatness (double flat) { flatness = flat; };	// default 0.8
+  void set_final_ln_f (double ln_f) { final_ln_f = ln_f; };	// 1.e-6
+  void set_check_sweeps (int sweeps) { check_sweeps = sweeps; };	// 10
+  void set_threads (int num_threads) { threads = num_threads; };	// 0 = all
+
+  void run ();			// until ln f < final_ln_f in every window
+
+  int get_num_sites () const { return lattice.get_num_sites (); };
+  int get_num_bonds () const { return num_bonds; };
+  int get_num_energies () const { return 2 * num_bonds + 1; };
+  double energy_i (int i) const { return double (i - num_bonds); };
+  bool reached (int i) const { return (seen[i] != 0); };	// g(E_i) > 0
+  double ln_g (int i) const { return ln_dos[i]; };	// 0 if not reached
+  long long get_num_flips () const { return num_flips; };
+
+  // ln Z, <E> and C = (<E^2> - <E>^2)/kT^2 at temperature kT
+  void thermodynamics (double kT, double &ln_Z, double &energy,
+                       double &specific_heat) const;
+
+private:
+  WangLandau (const WangLandau &);	// not copyable
+  WangLandau &operator= (const WangLandau &);
+
+  struct Walker
+  {
+    std::vector<int> config;	// spins, +1 or -1
+    int i;			// current energy index
+    gsl_rng *rng;
+    std::vector<double> ln_g;	// window ln g plus this walker's changes
+    std::vector<long long> visits;	// histogram since the last check
+  };
+  struct Window
+  {
+    int lo, hi;			// energy indices lo..hi
+    double ln_f;		// current modification factor
+    bool one_over_t;		// ln f = 1/t from now on
+    bool done;
+    long long steps;		// steps of all its walkers so far
+    int num_seen;		// number of energies visited so far
+    std::vector<double> ln_g;	// indexed by i - lo
+    std::vector<long long> visits;	// histogram of the current stage
+    std::vector<char> seen;	// energies visited so far
+  };
+
+  void enter_window (Walker &w, const Window &win);
+  void walk (Walker &w, const Window &win, long long num_steps);
+  bool merge_walkers (int k);	// returns true if the histogram is flat
+  void join_windows ();
+
+  IsingLattice lattice;
+  int num_bonds;
+  int num_windows;
+  int walkers_per_window;
+  double flatness;
+  double final_ln_f;
+  int check_sweeps;
+  int threads;
+  long long num_flips;		// spin-flip attempts so far
+
+  std::vector<Window> window;
+  std::vector<Walker> walker;	// walker w is in window w / walkers_per_window
+  std::vector<double> ln_dos;	// joined and normalized ln g(E_i)
+  std::vector<char> seen;
+};
+
+#endif
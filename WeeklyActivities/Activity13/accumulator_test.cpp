@@ -0,0 +1,150 @@
+//  file: accumulator_test.cpp
+//
+//  Test program for the MCAccumulator class.
+//   1. Feeds it an AR(1) series x_t = rho x_{t-1} + sqrt(1-rho^2) g_t
+//      (g_t gaussian), whose integrated autocorrelation time is known,
+//      tau_int = (1/2)(1+rho)/(1-rho), and prints the naive and blocked
+//      errors and the measured tau_int.
+//   2. Fills one accumulator per OpenMP thread, merges them at the end,
+//      and compares with one accumulator fed all of the values.
+//   3. Adds the same values in blocks with add_independent() and
+//      compares the mean and variance with those from add().
+//
+//  Revision history:
+//      27-May-2021  original version
+//      01-Jun-2021  master seed from RngStreams (RNG_SEED repeats a run)
+//      07-Jun-2021  check of add_independent()
+//
+//  Notes:
+//   * the error of the mean of the AR(1) series is
+//      sqrt(2 tau_int / n), also printed for comparison.
+//   * compile with make -f make_accumulator_test (needs -fopenmp)
+//
+//*********************************************************************//
+
+// include files
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+using namespace std;
+#include <omp.h>
+#include <gsl/gsl_rng.h>	// GSL random number generators
+#include <gsl/gsl_randist.h>	// GSL random distributions
+
+#include "MCAccumulator.h"
+#include "RngStreams.h"		// master seed and streams
+
+// function prototypes
+void ar1_series (gsl_rng *rng_ptr, double rho, long n, double x[]);
+
+//*********************************************************************//
+int
+main (void)
+{
+  gsl_rng *rng_ptr = RngStreams::thread_rng ();
+  cout << endl;
+
+  // 1. known autocorrelation times
+  const long n = 1L << 22;
+  vector<double> x (n);
+  const double rho_list[] = { 0., 0.5, 0.9, 0.99 };
+
+  cout << "#  rho    mean      naive err  blocked err  exact err"
+       << "   tau_int  exact" << endl;
+  for (int r = 0; r < 4; r++)
+  {
+    double rho = rho_list[r];
+    ar1_series (rng_ptr, rho, n, &x[0]);
+    MCAccumulator acc;
+    for (long t = 0; t < n; t++)
+    {
+      acc.add (x[t]);
+    }
+    double tau_exact = 0.5 * (1. + rho) / (1. - rho);
+    cout << fixed << setprecision (2) << setw (6) << rho << "  "
+         << setprecision (5) << setw (8) << acc.mean () << "  "
+         << scientific << setprecision (3) << acc.naive_error () << "  "
+         << acc.error () << "  " << sqrt (2. * tau_exact / double (n))
+         << "  " << fixed << setprecision (2) << setw (7) << acc.tau_int ()
+         << "  " << setw (6) << tau_exact << endl;
+  }
+
+  // 2. one accumulator per thread, each with its own chain, merged
+  int num_threads = omp_get_max_threads ();
+  num_threads = (num_threads < 4 ? 4 : num_threads);
+  const long n_chain = n / num_threads;
+  vector<double> all (n_chain * num_threads);
+  vector<MCAccumulator> partial (num_threads);
+  int t;
+#pragma omp parallel for num_threads(num_threads)
+  for (t = 0; t < num_threads; t++)
+  {
+    gsl_rng *chain_rng = RngStreams::new_rng (1 + t);
+    ar1_series (chain_rng, 0.9, n_chain, &all[t * n_chain]);
+    for (long i = 0; i < n_chain; i++)
+    {
+      partial[t].add (all[t * n_chain + i]);
+    }
+    gsl_rng_free (chain_rng);
+  }
+  MCAccumulator merged, single;
+  for (t = 0; t < num_threads; t++)
+  {
+    merged.merge (partial[t]);
+  }
+  for (long i = 0; i < n_chain * num_threads; i++)
+  {
+    single.add (all[i]);
+  }
+
+  cout << endl << num_threads << " chains of " << n_chain
+       << " (rho = 0.9), merged vs. one accumulator:" << endl;
+  cout << "  count    " << merged.count () << "  " << single.count () << endl;
+  cout << scientific << setprecision (10);
+  cout << "  mean     " << merged.mean () << "  " << single.mean () << endl;
+  cout << "  variance " << merged.variance () << "  " << single.variance ()
+       << endl;
+  cout << fixed << setprecision (3);
+  cout << "  tau_int  " << merged.tau_int () << "  " << single.tau_int ()
+       << endl;
+  bool agree = (merged.count () == single.count ()
+                && fabs (merged.mean () - single.mean ()) < 1.e-12
+                && fabs (merged.variance () / single.variance () - 1.)
+                   < 1.e-12);
+  cout << (agree ? "merge checks out" : "merge is WRONG") << endl;
+
+  // 3. the same values in blocks of 1000 (the last one shorter)
+  MCAccumulator blocks;
+  for (long i = 0; i < n_chain * num_threads; i += 1000)
+  {
+    long m = (n_chain * num_threads - i < 1000 ? n_chain * num_threads - i
+              : 1000);
+    blocks.add_independent (&all[i], m);
+  }
+  bool same = (blocks.count () == single.count ()
+               && fabs (blocks.mean () - single.mean ()) < 1.e-12
+               && fabs (blocks.variance () / single.variance () - 1.)
+                  < 1.e-12);
+  cout << "add_independent in blocks: mean " << scientific
+       << setprecision (10) << blocks.mean () << ", variance "
+       << blocks.variance () << endl;
+  cout << (same ? "add_independent checks out" : "add_independent is WRONG")
+       << endl;
+
+  return (agree && same ? 0 : 1);
+}
+
+//*********************************************************************//
+// n values of an AR(1) series with unit variance, started in equilibrium
+void
+ar1_series (gsl_rng *rng_ptr, double rho, long n, double x[])
+{
+  double noise = sqrt (1. - rho * rho);
+  double value = gsl_ran_gaussian (rng_ptr, 1.);
+  for (long t = 0; t < n; t++)
+  {
+    value = rho * value + noise * gsl_ran_gaussian (rng_ptr, 1.);
+    x[t] = value;
+  }
+}
@@ -0,0 +1,128 @@
+//  file: ising_cluster_bench.cpp
+//
+//  Autocorrelation benchmark for the IsingEngine updates: Metropolis
+//   (checkerboard) sweeps, Wolff clusters, and Swendsen-Wang.  For each
+//   it measures the integrated autocorrelation times of E and |M| and
+//   the time per measurement, and from those the number of effectively
+//   independent samples per second.
+//
+//  Revision history:
+//      24-May-2021  original version
+//      01-Jun-2021  master seed from RngStreams (RNG_SEED repeats a run)
+//      06-Jun-2021  tau_int from MCAccumulator, without storing the series
+//
+//  Notes:
+//   * one measurement is one sweep for Metropolis, one SW update, or a
+//      fixed number of Wolff clusters that flip about L*L sites in total
+//      (from the mean cluster size during equilibration).  Measuring
+//      whenever the flipped sites reach L*L would bias the averages,
+//      since the stopping time would depend on the cluster sizes.
+//   * tau_int = (1/2) (blocked error / naive error)^2 from MCAccumulator,
+//      in units of measurements.  n samples are worth n / (2 tau_int)
+//      independent ones.
+//   * the three <E>/N and <|M|>/N should agree within the statistical
+//      errors, which is a check of the cluster updates.
+//   * compile with make -f make_ising_cluster_bench (needs -fopenmp)
+//
+//*********************************************************************//
+
+// include files
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+using namespace std;
+#include <omp.h>
+
+#include "IsingEngine.h"
+#include "MCAccumulator.h"	// averages with blocked error bars
+#include "RngStreams.h"		// master seed and streams
+
+//*********************************************************************//
+int
+main (void)
+{
+  int L, num_meas;
+  double kT;
+  unsigned long int seed = RngStreams::master_seed ();
+
+  cout << "Linear size L (even, e.g. 64): ";
+  cin >> L;
+  cout << "Temperature kT (2.269 is critical): ";
+  cin >> kT;
+  cout << "Number of measurements per method (e.g. 20000): ";
+  cin >> num_meas;
+  cout << endl;
+
+  const char *name[3] = { "Metropolis   ", "Wolff        ", "Swendsen-Wang" };
+  double metropolis_rate = 0.;
+
+  cout << "# method         ms/meas    <E>/N    <|M|>/N   tau_E    tau_M"
+       << "   eff/s(M)  speedup" << endl;
+  for (int method = 0; method < 3; method++)
+  {
+    IsingEngine ising (L, kT, seed + method);
+    double N = double (ising.get_num_sites ());
+    MCAccumulator energy_acc, magnet_acc;	// E/N and |M|/N
+    long long flipped = 0;	// sites flipped by Wolff so far
+    long long num_clusters = 0;	//  in num_clusters clusters
+    int clusters_per_meas = 1;
+
+    double start = 0.;
+    for (int step = -num_meas / 10; step < num_meas; step++)
+    {
+      if (step == 0)		// negative steps are for equilibration
+      {
+        start = omp_get_wtime ();
+        if (num_clusters > 0)
+        {
+          clusters_per_meas = int (ceil (N * num_clusters / flipped));
+        }
+      }
+      if (method == 0)
+      {
+        ising.sweep ();
+      }
+      else if (method == 1)
+      {
+        for (int c = 0; c < (step < 0 ? 1 : clusters_per_meas); c++)
+        {
+          flipped += ising.wolff_step ();
+          num_clusters++;
+        }
+      }
+      else
+      {
+        ising.swendsen_wang_step ();
+      }
+      if (step >= 0)
+      {
+        energy_acc.add (ising.energy () / N);
+        magnet_acc.add (fabs (double (ising.magnetization ())) / N);
+      }
+    }
+    double t = (omp_get_wtime () - start) / num_meas;
+
+    double e_mean = energy_acc.mean ();
+    double m_mean = magnet_acc.mean ();
+    double tau_E = energy_acc.tau_int ();
+    double tau_M = magnet_acc.tau_int ();
+    double rate = 1. / (2. * tau_M * t);	// independent samples per s
+    if (method == 0)
+    {
+      metropolis_rate = rate;
+    }
+
+    cout << "  " << name[method] << fixed << setprecision (4) << setw (9)
+         << 1000. * t << setw (10) << e_mean << setw (9) << m_mean
+         << setprecision (2) << setw (9) << tau_E << setw (9) << tau_M
+         << setprecision (1) << setw (11) << rate << setprecision (2)
+         << setw (8) << rate / metropolis_rate << endl;
+    if (fabs (ising.energy () - ising.calculate_energy ()) > 0.5)
+    {
+      cout << "energy bookkeeping is WRONG" << endl;
+      return (1);
+    }
+  }
+
+  return (0);
+}
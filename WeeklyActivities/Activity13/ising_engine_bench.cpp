@@ -0,0 +1,146 @@
+//  file: ising_engine_bench.cpp
+//
+//  Test and benchmark program for the IsingEngine class.
+//   1. On a small lattice, compares the averages of the energy and |M|
+//      per site from the sequential (typewriter) sweep and from the
+//      checkerboard sweep; they should agree within the error bars.
+//   2. Times checkerboard sweeps of an L x L lattice on 1, 2, ...
+//      threads and prints the throughput in spin flips (attempted
+//      single-spin updates) per nanosecond.
+//
+//  Revision history:
+//      20-May-2021  original version
+//      01-Jun-2021  master seed from RngStreams (RNG_SEED repeats a run)
+//      06-Jun-2021  error bars from MCAccumulator
+//
+//  Notes:
+//   * the error bars are blocked error bars from MCAccumulator, with the
+//      block length chosen from the data instead of a fixed 50 blocks
+//   * compile with make -f make_ising_engine_bench (needs -fopenmp)
+//
+//*********************************************************************//
+
+// include files
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstdlib>
+using namespace std;
+#include <omp.h>
+
+#include "IsingEngine.h"
+#include "MCAccumulator.h"	// averages with blocked error bars
+#include "RngStreams.h"		// master seed and streams
+
+// function prototypes
+void compare_sweeps (int L, double kT, int num_mcs, unsigned long int seed);
+
+//*********************************************************************//
+int
+main (void)
+{
+  int L;
+  int max_threads = omp_get_num_procs ();
+  unsigned long int seed = RngStreams::master_seed ();
+
+  cout << "Linear size L for the benchmark (e.g. 4096): ";
+  cin >> L;
+  cout << "Maximum number of threads (0 = " << max_threads << "): ";
+  int requested;
+  cin >> requested;
+  if (requested > 0)
+  {
+    max_threads = requested;
+  }
+  cout << endl;
+
+  // 1. sequential vs. checkerboard on a 16 x 16 lattice
+  cout << "# kT   sweep          <E>/N                   <|M|>/N" << endl;
+  compare_sweeps (16, 1.5, 20000, seed);
+  compare_sweeps (16, 2.5, 20000, seed);
+  compare_sweeps (16, 3.5, 20000, seed);
+
+  // 2. throughput of the checkerboard sweep
+  IsingEngine ising (L, 2.269, seed);
+  int num_mcs = (L >= 2048 ? 10 : int (4.e7 / (double (L) * L)) + 1);
+  double flips = double (ising.get_num_sites ()) * num_mcs;
+
+  cout << endl << "L = " << L << ", " << num_mcs << " mcs per timing, "
+       << ising.get_num_strips () << " strips" << endl;
+  cout << "# threads    time(s)   flips/ns   speedup" << endl;
+
+  double start = omp_get_wtime ();
+  for (int step = 0; step < num_mcs; step++)
+  {
+    ising.sweep_sequential ();
+  }
+  double t_seq = omp_get_wtime () - start;
+  cout << "  sequential " << fixed << setprecision (4) << setw (9) << t_seq
+       << "  " << setw (9) << flips / t_seq * 1.e-9 << endl;
+
+  double t1 = 0.;
+  for (int T = 1; T <= max_threads; T++)
+  {
+    ising.set_threads (T);
+    start = omp_get_wtime ();
+    for (int step = 0; step < num_mcs; step++)
+    {
+      ising.sweep ();
+    }
+    double t = omp_get_wtime () - start;
+    if (T == 1)
+    {
+      t1 = t;
+    }
+    cout << "  " << setw (9) << T << "  " << setw (9) << t << "  "
+         << setw (9) << flips / t * 1.e-9 << "  " << setprecision (2)
+         << setw (8) << t1 / t << setprecision (4) << endl;
+  }
+
+  // the tracked energy must still equal the energy from scratch
+  if (fabs (ising.energy () - ising.calculate_energy ()) > 0.5)
+  {
+    cout << "energy bookkeeping is WRONG: " << ising.energy () << " vs "
+         << ising.calculate_energy () << endl;
+    return (1);
+  }
+  return (0);
+}
+
+//*********************************************************************//
+// Run num_mcs sweeps each way after num_mcs/10 to equilibrate and print
+//  the averages of E/N and |M|/N with their blocked error bars
+void
+compare_sweeps (int L, double kT, int num_mcs, unsigned long int seed)
+{
+  for (int method = 0; method < 2; method++)
+  {
+    IsingEngine ising (L, kT, seed + method);
+    double N = double (ising.get_num_sites ());
+    MCAccumulator energy_acc, magnet_acc;	// E/N and |M|/N, one per mcs
+
+    for (int step = -num_mcs / 10; step < num_mcs; step++)
+    {
+      if (method == 0)
+      {
+        ising.sweep_sequential ();
+      }
+      else
+      {
+        ising.sweep ();
+      }
+      if (step >= 0)		// negative steps are for equilibration
+      {
+        energy_acc.add (ising.energy () / N);
+        magnet_acc.add (fabs (double (ising.magnetization ())) / N);
+      }
+    }
+
+    cout << fixed << setprecision (2) << "  " << kT << "  "
+         << (method == 0 ? "sequential  " : "checkerboard")
+         << setprecision (5) << setw (10) << energy_acc.mean () << " +/- "
+         << setw (7) << energy_acc.error () << setw (12)
+         << magnet_acc.mean () << " +/- " << setw (7)
+         << magnet_acc.error () << endl;
+  }
+}
@@ -0,0 +1,99 @@
+//  file: ising_exact.cpp
+//
+//  Program to find the exact density of states g(E) (energy_count[]) of
+//   a periodic Ising chain or small square lattice with the Gray-code
+//   IsingEnumerator, and to check it.
+//
+//  Revision history:
+//      25-May-2021  original version
+//
+//  Notes:
+//   * checks: the counts must add up to 2^N, and for a ring of N spins
+//      the number of configurations with k anti-aligned bonds is
+//      2 C(N,k) for even k (and 0 for odd k).  For a square lattice the
+//      two ground states give energy_count[0] = 2.
+//   * the counts go to ising_exact.dat
+//   * compile with make -f make_ising_exact (needs -fopenmp)
+//
+//*********************************************************************//
+
+// include files
+#include <iostream>		// cout and cin
+#include <iomanip>		// manipulators like setprecision
+#include <fstream>		// file input and output
+#include <cmath>
+using namespace std;
+#include <omp.h>
+
+#include "IsingEnumerator.h"
+
+//*********************************************************************//
+int
+main (void)
+{
+  int Lx, Ly, num_threads;
+
+  cout << "Lattice Lx Ly (Ly = 1 for a chain, e.g. 24 1 or 5 5): ";
+  cin >> Lx >> Ly;
+  cout << "Number of threads (0 = all): ";
+  cin >> num_threads;
+
+  IsingEnumerator lattice (Lx, Ly);
+  int N = lattice.get_num_sites ();
+  int num_energies = lattice.get_num_energies ();
+  long long *energy_count = new long long[num_energies];
+
+  double start = omp_get_wtime ();
+  lattice.count_energies (energy_count, num_threads);
+  double elapsed = omp_get_wtime () - start;
+
+  long long total = 0;
+  for (int i = 0; i < num_energies; i++)
+  {
+    total += energy_count[i];
+  }
+  cout << total << " configurations (2^" << N << " = " << (1LL << N)
+       << ") in " << fixed << setprecision (3) << elapsed << " s, "
+       << setprecision (3) << double (total) / elapsed * 1.e-9
+       << " per ns" << endl;
+  int errors = (total != (1LL << N));
+
+  if (Ly == 1)			// E = 2k - N for k anti-aligned bonds
+  {
+    double binomial = 1.;	// C(N,k)
+    for (int k = 0; k <= N; k++)
+    {
+      long long expected = (k % 2 == 0 ? (long long) (2. * binomial + 0.5)
+                            : 0);
+      if (energy_count[2 * k] != expected)
+      {
+        errors++;
+      }
+      binomial *= double (N - k) / double (k + 1);
+    }
+  }
+  else if (energy_count[0] != 2)
+  {
+    errors++;
+  }
+  cout << (errors == 0 ? "counts check out" : "counts are WRONG") << endl;
+
+  // output the energy counts
+  ofstream out;
+  out.open ("ising_exact.dat");
+  out << "# exact energy counts for " << Lx << " x " << Ly << endl;
+  out << "#  energy        count" << endl;
+  for (int i = 0; i < num_energies; i++)
+  {
+    if (energy_count[i] != 0)
+    {
+      out << "  " << setw (6) << int (lattice.energy_i (i)) << "  "
+          << setw (14) << energy_count[i] << endl;
+    }
+  }
+  out.close ();
+  cout << "Energy counts output to ising_exact.dat" << endl;
+
+  delete[] energy_count;
+  return (errors == 0 ? 0 : 1);
+}
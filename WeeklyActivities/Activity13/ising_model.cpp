@@ -14,10 +14,16 @@
 //                    sampling_test.cpp
 //      20-Feb-2005  minor changes to comments
 //      20-Feb-2007  eliminated compile stuff, 
+//      22-May-2021  acceptance from a MetropolisTable of integer
+//                    thresholds (no exp() in the loop)
+//      26-May-2021  O(1) delta_energy from an IsingLattice instead of
+//                    calculate_energy; the free-boundary 2D lattice
+//                    now has the bonds of the last row and column too
+//      01-Jun-2021  master seed from RngStreams (RNG_SEED repeats a run)
 //
 //  Notes:
-//   * uses the GSL random number functions and random_seed() to seed them.
-//   * uses the GSL random number functions and random_seed(),
+//   * uses the GSL random number functions and RngStreams to seed them.
+//   * uses the GSL random number functions and RngStreams,
 //      and both the gsl_rng.h and gsl_randist.h header files are needed.
 //
 //******************************************************************
@@ -32,22 +38,24 @@ using namespace std;		// we need this when .h is omitted
 #include <gsl/gsl_rng.h>	// GSL random number generators
 #include <gsl/gsl_randist.h>	// GSL random distributions
 
-// function prototypes
-extern unsigned long int random_seed ();	// routine to generate a seed
-double calculate_energy (int configuration[]);  // calculate the energy given
-                                                //  a spin configuration
+#include "MetropolisTable.h"	// integer thresholds for acceptance
+#include "IsingLattice.h"	// neighbour table and energies
+#include "RngStreams.h"		// master seed and streams
+
 // global constants
 const double J_ising = 1.;      // The "J" in the Ising model (+1 or -1 ONLY) 
 const int linear_sites = 20;    // number of lattice sites in one direction
 
-// For one dimensional Ising model, uncomment the next two lines:
+// For one dimensional Ising model, uncomment the next three lines:
 /*
 const int num_sites = linear_sites;
 const int dimension = 1;
+const bool periodic = true;    // periodic boundary conditions
 */
-// For two dimensional Ising model, uncomment the next two lines
+// For two dimensional Ising model, uncomment the next three lines
 const int num_sites = linear_sites * linear_sites;
 const int dimension = 2;
+const bool periodic = false;   // free boundary conditions
   
                                  // number of different energies
 const int num_energies = 2 * dimension * num_sites + 1;  
@@ -71,8 +79,10 @@ main (void)
   }
 
   //  Set up the GSL random number generators (rng's)
-  gsl_rng *rng_ptr = gsl_rng_alloc (gsl_rng_taus);   // allocate an rng 
-  gsl_rng_set (rng_ptr, random_seed());	             // seed the rng 
+  gsl_rng *rng_ptr = RngStreams::thread_rng ();	// seeded from the master seed
+
+  // acceptance thresholds for s*h = -2*dimension..2*dimension
+  MetropolisTable metropolis (rng_ptr, kT, J_ising, 2 * dimension);
 
   // Open up an output file
   ofstream out;
@@ -83,8 +93,9 @@ main (void)
   
   
   // Find the energy distribution from a Markov chain of configurations
-  double energy, energy0;
+  double energy0;
   int config_metropolis[num_sites];   // current configuration
+  IsingLattice lattice (dimension, linear_sites, periodic, J_ising);
 
   // generate a random configuration to start and find its energy
   for (int i = 0; i < num_sites; i++)
@@ -98,8 +109,8 @@ main (void)
     {
       config_metropolis[i] = +1;  // spin up
     }
-    energy0 = calculate_energy ( config_metropolis );
   } 
+  energy0 = lattice.energy ( config_metropolis );
   
   // Take num_mcs Monte Carlo steps (mcs)  
   for (int step = 0; step < num_mcs; step++)
@@ -110,22 +121,19 @@ main (void)
       double random = gsl_ran_flat (rng_ptr, 0., 1.);
       int id = int(random * num_sites);  // from 0 to num_sites
 
-      // flip that spin (i.e., if +/- 1, change to -/+ 1)
-      config_metropolis[id] *= -1;  
-
-      energy = calculate_energy( config_metropolis );  // new energy
-      double delta_energy = energy - energy0;
+      // energy change if that spin is flipped: O(1) from its neighbours
+      int sh = config_metropolis[id]
+               * lattice.local_field (config_metropolis, id);  // = s*h
+      double delta_energy = 2. * J_ising * sh;
 
       // decide whether to accept or reject the new configuration
-      random = gsl_ran_flat (rng_ptr, 0., 1.);
-      if ( (delta_energy > 0.) && (random > exp(-delta_energy/kT)) )
+      //  (same test as delta_energy > 0 and gsl_ran_flat > exp(-delta_E/kT))
+      unsigned long int random_bits = gsl_rng_get (rng_ptr);
+      if ( metropolis.accept (random_bits, sh) )
       {
-        // reject the new configuration: flip the spin back
-        config_metropolis[id] *= -1; 
-      }
-      else
-      {
-        energy0 = energy;  // accept the new configuration
+        // accept: flip that spin (i.e., if +/- 1, change to -/+ 1)
+        config_metropolis[id] *= -1;
+        energy0 += delta_energy;
       }
     }
     // add to distribution
@@ -168,53 +176,3 @@ main (void)
 
   return (0);
 }
-
-//************************* calculate_energy ******************************
-//
-//  Given the array of integers configuration[0...num_sites-1], which 
-//   specifies the spin at each lattice point, find the energy of that 
-//   configuration [eq.(13.6) in Session 13 notes].
-//  Note that a freeboundary condition is specified here.
-//
-//*************************************************************************
-double 
-calculate_energy (int configuration[])
-{
-  int nearest = 0;
-  double energy = 0.;
-
-  if (dimension == 1) 
-  { 
-    for (int i = 0; i < num_sites - 1; i++)  // step through all but one site
-    {
-      nearest = i + 1;   // nearest neighbor on a line
-      energy += - J_ising * double(configuration[i] * configuration[nearest]);
-    }
-    
-    // now for the last site using periodic boundary conditions
-    nearest = num_sites - 1;
-    energy += - J_ising * double(configuration[nearest] * configuration[0]);
-  }
-  else if (dimension == 2)
-  {  
-  // go through the 2d lattice with free boundary conditions
-    for (int i = 0; i < linear_sites - 1; i++)
-    {
-      for (int j = 0; j < linear_sites - 1; j++)
-      {
-        int id = i + j * linear_sites;
-
-        // x direction
-        nearest = id + 1;
-        energy += - J_ising * double(configuration[id]*configuration[nearest]);
-
-        // y direction;
-        nearest = id + linear_sites;
-        energy += - J_ising * double(configuration[id]*configuration[nearest]);
-      }
-    }
-  }
-
-  return (energy);
-} 
-
@@ -16,10 +16,18 @@
 //                    by S.Y. Park
 //      20-Feb-2005  minor changes to comments
 //      20-Feb-2007  added comments and J_ising
+//      22-May-2021  acceptance from a MetropolisTable of integer
+//                    thresholds (no exp() or gsl_ran_flat in the loop)
+//      26-May-2021  nearest_neighbor table and energy from IsingLattice,
+//                    so 1D and 3D work too
+//      27-May-2021  <E>/N and <|M|>/N with blocked error bars and tau_int
+//                    from MCAccumulator
+//      01-Jun-2021  master seed from RngStreams (RNG_SEED repeats a run)
+//      05-Jun-2021  energy distribution P(E) in a Histogram
 //
 //  Notes:
-//   * uses the GSL random number functions and random_seed() to seed them.
-//   * uses the GSL random number functions and random_seed(),
+//   * uses the GSL random number functions and RngStreams to seed them.
+//   * uses the GSL random number functions and RngStreams,
 //      and both the gsl_rng.h and gsl_randist.h header files are needed.
 //
 //******************************************************************
@@ -34,21 +42,33 @@ using namespace std;		// we need this when .h is omitted
 #include <gsl/gsl_rng.h>	// GSL random number generators
 #include <gsl/gsl_randist.h>	// GSL random distributions
 
-// function prototypes
-extern unsigned long int random_seed ();	// routine to generate a seed
-double calculate_energy (int configuration[],int nearest[][4]);  
-                                                // calculate the energy given
-                                                //  a spin configuration
+#include "MetropolisTable.h"	// integer thresholds for acceptance
+#include "IsingLattice.h"	// neighbour table and energies
+#include "MCAccumulator.h"	// averages with blocked error bars
+#include "Histogram.h"		// energy distribution
+#include "RngStreams.h"		// master seed and streams
+
 // global constants
 const double J_ising = 1.;      // The "J" in the Ising model (+1 or -1 ONLY) 
 const int linear_sites = 20;       // number of lattice sites in one direction
 
-// two-dimensional Ising model only
+// For one dimensional Ising model, uncomment the next two lines:
+/*
+const int num_sites = linear_sites;
+const int dimension = 1;
+*/
+// For two dimensional Ising model, uncomment the next two lines
 const int num_sites = linear_sites * linear_sites;
 const int dimension = 2;
+// For three dimensional Ising model, uncomment the next two lines:
+/*
+const int num_sites = linear_sites * linear_sites * linear_sites;
+const int dimension = 3;
+*/
                                  // number of different energies
 const int num_energies = 2 * dimension * num_sites + 1;  
 const int num_mcs = 10000;       // # of Monte Carlo steps (mcs)
+const int num_equil = num_mcs / 10;   // mcs before the averages start
 
 
 //**************************************************************************
@@ -59,35 +79,24 @@ main (void)
   cout << "What temperature? (kT) ";
   cin >> kT;
 
-  double dist_metropolis[num_energies]; // energy distribution at kT from 
-                                        //  importance sampling (Metropolis)
-  // initialize energy distribution histogram to zero
-  for (int i = 0; i < num_energies; i++)
-  {
-    dist_metropolis[i] = 0.;
-  }
+  // energy distribution at kT from importance sampling (Metropolis):
+  //  bin i is centered on the energy i - dimension*num_sites
+  Histogram dist_metropolis (num_energies, -dimension*num_sites - 0.5,
+                             dimension*num_sites + 0.5);
 
   //  Set up the GSL random number generators (rng's)
-  gsl_rng *rng_ptr = gsl_rng_alloc (gsl_rng_taus);   // allocate an rng 
-  gsl_rng_set (rng_ptr, random_seed());	             // seed the rng 
+  gsl_rng *rng_ptr = RngStreams::thread_rng ();	// seeded from the master seed
+
+  // acceptance thresholds for s*h = -2*dimension..2*dimension
+  MetropolisTable metropolis (rng_ptr, kT, J_ising, 2 * dimension);
  
   // Find the energy distribution from a Markov chain of configurations
   double energy0;
   int config_metropolis[num_sites];   // current configuration
-  int nearest_neighbor[num_sites][4];   // nearest_neighbor_site
+  // periodic lattice: nearest_neighbor table built once
+  IsingLattice lattice (dimension, linear_sites, true, J_ising);
 
   // generate a random configuration to start and find its energy
-  for (int i = 0; i < linear_sites ; i++)
-  {
-    for (int j = 0; j < linear_sites ; j++)
-    {
-      int id=i+j*linear_sites;  
-      nearest_neighbor[id][0]=(i-1+linear_sites)%linear_sites+j*linear_sites;
-      nearest_neighbor[id][1]=(i+1)%linear_sites+j*linear_sites;
-      nearest_neighbor[id][2]=i+(j-1+linear_sites)%linear_sites*linear_sites;
-      nearest_neighbor[id][3]=i+(j+1)%linear_sites*linear_sites;
-    }
-  }
   for (int i = 0; i < num_sites; i++)
   {
     double random = gsl_ran_flat (rng_ptr, 0., 1.);
@@ -99,8 +108,14 @@ main (void)
     {
       config_metropolis[i] = +1;  // spin up
     }
-    energy0 = calculate_energy ( config_metropolis,nearest_neighbor );
   } 
+  energy0 = lattice.energy ( config_metropolis );
+  int magnet0 = 0;                    // current magnetization
+  for (int i = 0; i < num_sites; i++)
+  {
+    magnet0 += config_metropolis[i];
+  }
+  MCAccumulator energy_acc, magnet_acc;   // E/N and |M|/N, one per mcs
   // Open up an output file
   ofstream out;
   out.open ("ising_opt.dat");
@@ -114,31 +129,35 @@ main (void)
     for (int i = 0; i < num_sites; i++)  // Entire loop is only one mcs  
     {
 
-      double delta_energy = 2*config_metropolis[i] 
-      *(config_metropolis[nearest_neighbor[i][0]]
-       +config_metropolis[nearest_neighbor[i][1]]
-       +config_metropolis[nearest_neighbor[i][2]]
-       +config_metropolis[nearest_neighbor[i][3]]);
+      int sh = config_metropolis[i]
+               * lattice.local_field (config_metropolis, i);
+      double delta_energy = 2. * J_ising * sh;
 
 
       // decide whether to accept or reject the new configuration
       if (delta_energy < 0.) 
       {
         energy0 += delta_energy;  // accept the new configuration
+        magnet0 -= 2 * config_metropolis[i];
         config_metropolis[i] *= -1; 
       }
       else 
       {
-        double random = gsl_ran_flat (rng_ptr, 0., 1.);
-        if(random < exp(-delta_energy/kT)) 
+        // same test as gsl_ran_flat (rng_ptr, 0., 1.) < exp(-delta_energy/kT)
+        if (metropolis.accept (gsl_rng_get (rng_ptr), sh)) 
         {
           energy0 += delta_energy;  // accept the new configuration
+          magnet0 -= 2 * config_metropolis[i];
           config_metropolis[i] *= -1; 
         }
       }
     }
-    // add to distribution
-    dist_metropolis[dimension * num_sites + (int)energy0] += 1.;  
+    dist_metropolis.add (energy0);	// add to distribution
+    if (step >= num_equil)
+    {
+      energy_acc.add (energy0 / double (num_sites));
+      magnet_acc.add (abs (magnet0) / double (num_sites));
+    }
 
     // print out every once in a while the current energy
     if ( (step < 100) || (step % 10 == 0) )
@@ -150,12 +169,14 @@ main (void)
   }
   out.close ();
   cout << "Time evolution of energy output to ising_opt.dat" << endl;
-    
-  // normalize the distribution
-  for (int i = 0; i < num_energies; i++)
-  {
-    dist_metropolis[i] /= (double)num_mcs;
-  }
+  cout << fixed << setprecision (5)
+       << "  <E>/N   = " << energy_acc.mean () << " +/- "
+       << energy_acc.error () << "  (tau_int = " << setprecision (2)
+       << energy_acc.tau_int () << " mcs)" << endl;
+  cout << setprecision (5)
+       << "  <|M|>/N = " << magnet_acc.mean () << " +/- "
+       << magnet_acc.error () << "  (tau_int = " << setprecision (2)
+       << magnet_acc.tau_int () << " mcs)" << endl;
 
 
   //*******************************************************************
@@ -167,7 +188,7 @@ main (void)
   {
     histogram << fixed << "  " << setw(5) << i - dimension*num_sites << "  "
               << fixed << setprecision(8)
-              << setw(11) << dist_metropolis[i] << " "
+              << setw(11) << dist_metropolis.probability (i) << " "
               << endl;
   }
   histogram << endl;
@@ -177,37 +198,3 @@ main (void)
 
   return (0);
 }
-
-//************************* calculate_energy ******************************
-//
-//  Given the array of integers configuration[0...num_sites-1], which 
-//   specifies the spin at each lattice point, find the energy of that 
-//   configuration [eq.(13.6) in Session 13 notes].
-//  Note that a free boundary condition is specified here.
-//
-//*************************************************************************
-double 
-calculate_energy (int configuration[],int nearest[][4])
-{
-  double energy = 0.;
-
-  // go through the 2d lattice with periodic boundary conditions
-  for (int i = 0; i < linear_sites ; i++)
-  {
-    for (int j = 0; j < linear_sites ; j++)
-    {
-      int id = i + j * linear_sites;
-
-      // x direction
-      energy += - J_ising * double(configuration[id] 
-                 * configuration[nearest[id][1]]);
-
-      // y direction;
-      energy += - J_ising * double(configuration[id] 
-              * configuration[nearest[id][3]]);
-    }
-  }
-
-  return (energy);
-} 
-
@@ -0,0 +1,169 @@
+//  file: ising_packed_bench.cpp
+//
+//  Test and benchmark program for the multi-spin coded IsingPacked class.
+//   1. On a 64 x 64 lattice, compares the averages of E/N and |M|/N with
+//      those of the byte-per-spin IsingEngine; they should agree within
+//      the error bars.
+//   2. Times sweeps of an L x L lattice with both classes and prints the
+//      throughput in spin flips (attempted updates) per nanosecond.
+//
+//  Revision history:
+//      21-May-2021  original version
+//      01-Jun-2021  master seed from RngStreams (RNG_SEED repeats a run)
+//
+//  Notes:
+//   * IsingEngine is skipped in part 2 for L > 16384 (it would need
+//      L*L bytes); IsingPacked needs L*L/8 bytes, 512 MB for L = 65536.
+//   * compile with make -f make_ising_packed_bench (needs -fopenmp)
+//
+//*********************************************************************//
+
+// include files
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+using namespace std;
+#include <omp.h>
+
+#include "IsingEngine.h"
+#include "IsingPacked.h"
+#include "RngStreams.h"		// master seed and streams
+
+// function prototypes
+void block_average (const double values[], int n, int num_blocks,
+                    double &mean, double &error);
+
+//*********************************************************************//
+int
+main (void)
+{
+  int L;
+  int num_threads;
+  unsigned long int seed = RngStreams::master_seed ();
+
+  cout << "Linear size L for the benchmark (a multiple of 64): ";
+  cin >> L;
+  cout << "Number of threads (0 = all): ";
+  cin >> num_threads;
+  cout << endl;
+
+  // 1. same averages as IsingEngine?
+  const int num_mcs = 10000;
+  const int small_L = 64;
+  double *energy = new double[num_mcs];
+  double *magnet = new double[num_mcs];
+  double kT_list[3] = { 1.5, 2.5, 3.5 };
+
+  cout << "# kT   class          <E>/N                   <|M|>/N" << endl;
+  for (int t = 0; t < 3; t++)
+  {
+    IsingEngine byte_ising (small_L, kT_list[t], seed);
+    IsingPacked bit_ising (small_L, kT_list[t], seed + 1);
+    byte_ising.set_all (+1);	// cold start: no stripes to melt at low kT
+    bit_ising.set_all (+1);
+    double N = double (small_L) * small_L;
+
+    for (int method = 0; method < 2; method++)
+    {
+      for (int step = -num_mcs / 10; step < num_mcs; step++)
+      {
+        double e, m;
+        if (method == 0)
+        {
+          byte_ising.sweep ();
+          e = byte_ising.energy ();
+          m = double (byte_ising.magnetization ());
+        }
+        else
+        {
+          bit_ising.sweep ();
+          e = bit_ising.energy ();
+          m = double (bit_ising.magnetization ());
+        }
+        if (step >= 0)		// negative steps are for equilibration
+        {
+          energy[step] = e / N;
+          magnet[step] = fabs (m) / N;
+        }
+      }
+      double e_mean, e_err, m_mean, m_err;
+      block_average (energy, num_mcs, 50, e_mean, e_err);
+      block_average (magnet, num_mcs, 50, m_mean, m_err);
+      cout << fixed << setprecision (2) << "  " << kT_list[t] << "  "
+           << (method == 0 ? "IsingEngine " : "IsingPacked ")
+           << setprecision (5) << setw (10) << e_mean << " +/- "
+           << setw (7) << e_err << setw (12) << m_mean << " +/- "
+           << setw (7) << m_err << endl;
+    }
+    if (fabs (bit_ising.energy () - bit_ising.calculate_energy ()) > 0.5)
+    {
+      cout << "energy bookkeeping is WRONG" << endl;
+      return (1);
+    }
+  }
+  delete[] energy;
+  delete[] magnet;
+
+  // 2. throughput at the critical temperature
+  const double kT_c = 2.269;
+  double N = double (L) * L;
+  int sweeps = (N >= 1.e8 ? 2 : int (2.e8 / N) + 1);
+  cout << endl << "L = " << L << ", kT = " << kT_c << ", " << sweeps
+       << " mcs per timing" << endl;
+  cout << "# class        memory(MB)   time(s)   flips/ns" << endl;
+
+  if (L <= 16384)
+  {
+    IsingEngine byte_ising (L, kT_c, seed);
+    byte_ising.set_threads (num_threads);
+    double start = omp_get_wtime ();
+    for (int step = 0; step < sweeps; step++)
+    {
+      byte_ising.sweep ();
+    }
+    double t = omp_get_wtime () - start;
+    cout << "  IsingEngine  " << fixed << setprecision (1) << setw (10)
+         << N / 1048576. << setprecision (4) << setw (10) << t
+         << setw (11) << N * sweeps / t * 1.e-9 << endl;
+  }
+
+  IsingPacked bit_ising (L, kT_c, seed);
+  bit_ising.set_threads (num_threads);
+  double start = omp_get_wtime ();
+  for (int step = 0; step < sweeps; step++)
+  {
+    bit_ising.sweep ();
+  }
+  double t = omp_get_wtime () - start;
+  cout << "  IsingPacked  " << fixed << setprecision (1) << setw (10)
+       << N / 8. / 1048576. << setprecision (4) << setw (10) << t
+       << setw (11) << N * sweeps / t * 1.e-9 << endl;
+
+  return (0);
+}
+
+//*********************************************************************//
+// mean of values[0..n-1] and its error from num_blocks block averages
+void
+block_average (const double values[], int n, int num_blocks,
+               double &mean, double &error)
+{
+  int block_size = n / num_blocks;
+  double sum = 0.;
+  double sum2 = 0.;
+
+  for (int b = 0; b < num_blocks; b++)
+  {
+    double block = 0.;
+    for (int k = b * block_size; k < (b + 1) * block_size; k++)
+    {
+      block += values[k];
+    }
+    block /= double (block_size);
+    sum += block;
+    sum2 += block * block;
+  }
+  mean = sum / num_blocks;
+  double var = (sum2 / num_blocks - mean * mean) / (num_blocks - 1);
+  error = (var > 0. ? sqrt (var) : 0.);
+}
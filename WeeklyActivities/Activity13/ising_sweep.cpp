@@ -0,0 +1,198 @@
+//  file: ising_sweep.cpp
+//
+//  Program to scan the two-dimensional Ising model over a range of
+//   temperatures in one run: one IsingEngine replica per temperature,
+//   the replicas swept in parallel (one per core), with optional
+//   replica exchange (parallel tempering) between neighbouring
+//   temperatures.  For each kT it prints the energy, |magnetization|,
+//   specific heat and susceptibility per site.
+//
+//  Revision history:
+//      23-May-2021  original version
+//      27-May-2021  MCAccumulator for the averages: error bars on E and
+//                    |M| and the autocorrelation time of E
+//      01-Jun-2021  master seed from RngStreams (RNG_SEED repeats a run)
+//      06-Jun-2021  replica seeds from RngStreams streams
+//
+//  Notes:
+//   * temperatures are evenly spaced from kT_min to kT_max.
+//   * every swap_interval mcs, neighbouring temperatures kT_t < kT_t+1
+//      try to exchange configurations (even pairs, then odd pairs), with
+//      acceptance min(1, exp[(1/kT_t - 1/kT_t+1)(E_t - E_t+1)]).  This
+//      keeps each temperature in equilibrium, and lets a configuration
+//      stuck at low kT wander up past T_c, decorrelate, and come back,
+//      which is much faster than waiting for it at fixed kT.  Only the
+//      temperatures are exchanged; the configurations stay in place.
+//      swap_interval = 0 runs independent chains instead.
+//   * per site, with E and M the totals over N = L*L sites:
+//        C   = (<E^2> - <E>^2) / (N kT^2)
+//        chi = (<M^2> - <|M|>^2) / (N kT)
+//   * the errors of <E>/N and <|M|>/N come from blocking, and tau_E is
+//      the integrated autocorrelation time of E in mcs (MCAccumulator.h);
+//      compare tau_E with and without replica exchange.
+//   * the run depends only on the seed, not on the number of threads.
+//   * compile with make -f make_ising_sweep (needs -fopenmp)
+//
+//*********************************************************************//
+
+// include files
+#include <iostream>		// cout and cin
+#include <iomanip>		// manipulators like setprecision
+#include <fstream>		// file input and output
+#include <cmath>
+#include <vector>
+using namespace std;
+#include <omp.h>
+
+#include <gsl/gsl_rng.h>	// GSL random number generators
+
+#include "IsingEngine.h"
+#include "MCAccumulator.h"	// averages with blocked error bars
+#include "RngStreams.h"		// master seed and streams
+
+// function prototypes
+int exchange_step (vector<IsingEngine *> &replica, vector<int> &at_temp,
+                   const vector<double> &kT, int parity, gsl_rng *rng_ptr,
+                   vector<long> &tried, vector<long> &accepted);
+
+//*********************************************************************//
+int
+main (void)
+{
+  int L, num_temps, num_mcs, swap_interval;
+  double kT_min, kT_max;
+
+  cout << "Linear size L (even): ";
+  cin >> L;
+  cout << "kT_min, kT_max, number of temperatures: ";
+  cin >> kT_min >> kT_max >> num_temps;
+  cout << "Number of mcs (after num_mcs/10 to equilibrate): ";
+  cin >> num_mcs;
+  cout << "Try replica exchange every how many mcs (0 = never)? ";
+  cin >> swap_interval;
+  if (num_temps < 2 || L < 2 || num_mcs < 10)
+  {
+    cout << "need at least 2 temperatures, L >= 2, and 10 mcs" << endl;
+    return (1);
+  }
+
+  //  Set up the GSL random number generator for the exchange moves
+  gsl_rng *rng_ptr = RngStreams::thread_rng ();	// seeded from the master seed
+
+  // the temperatures, and a hot-start replica at each one; at_temp[t] is
+  //  the replica currently at temperature kT[t]
+  vector<double> kT (num_temps);
+  vector<IsingEngine *> replica (num_temps);
+  vector<int> at_temp (num_temps);
+  for (int t = 0; t < num_temps; t++)
+  {
+    kT[t] = kT_min + (kT_max - kT_min) * t / double (num_temps - 1);
+    replica[t] = new IsingEngine (L, kT[t], RngStreams::stream_seed
+                                 (RngStreams::next_stream ()));
+    replica[t]->set_threads (1);	// the parallelism is over replicas
+    at_temp[t] = t;
+  }
+  double N = double (replica[0]->get_num_sites ());
+
+  // measurements at each temperature
+  vector<MCAccumulator> acc_E (num_temps), acc_M (num_temps);
+  vector<long> accepted (num_temps, 0);	// exchanges t <-> t+1
+  vector<long> tried (num_temps, 0);
+  int parity = 0;
+
+  double start = omp_get_wtime ();
+  for (int step = -num_mcs / 10; step < num_mcs; step++)
+  {
+    int r;
+#pragma omp parallel for schedule(dynamic,1)
+    for (r = 0; r < num_temps; r++)
+    {
+      replica[r]->sweep ();
+    }
+
+    if (swap_interval > 0 && (step + num_mcs) % swap_interval == 0)
+    {
+      exchange_step (replica, at_temp, kT, parity, rng_ptr, tried, accepted);
+      parity = 1 - parity;
+    }
+
+    if (step >= 0)		// negative steps are for equilibration
+    {
+      for (int t = 0; t < num_temps; t++)
+      {
+        double E = replica[at_temp[t]]->energy ();
+        double M = fabs (double (replica[at_temp[t]]->magnetization ()));
+        acc_E[t].add (E);
+        acc_M[t].add (M);
+      }
+    }
+  }
+  double elapsed = omp_get_wtime () - start;
+
+  // Open up an output file
+  ofstream out;
+  out.open ("ising_sweep.dat");
+  out << "# Ising model, L = " << L << ", " << num_mcs << " mcs, "
+      << (swap_interval > 0 ? "parallel tempering" : "independent chains")
+      << endl;
+  out << "#   kT       <E>/N      error     <|M|>/N      error"
+      << "       C/N        chi/N      tau_E    swap" << endl;
+  for (int t = 0; t < num_temps; t++)
+  {
+    double specific_heat = acc_E[t].variance () / (N * kT[t] * kT[t]);
+    double susceptibility = acc_M[t].variance () / (N * kT[t]);
+    double swap_rate = (tried[t] > 0 ? accepted[t] / double (tried[t]) : 0.);
+
+    out << fixed << setprecision (4) << setw (8) << kT[t] << "  "
+        << setprecision (6) << setw (10) << acc_E[t].mean () / N << "  "
+        << setw (9) << acc_E[t].error () / N << "  "
+        << setw (10) << acc_M[t].mean () / N << "  "
+        << setw (9) << acc_M[t].error () / N << "  "
+        << setw (10) << specific_heat << "  "
+        << setw (10) << susceptibility << "  " << setprecision (2)
+        << setw (8) << acc_E[t].tau_int () << "  " << setprecision (3)
+        << setw (6) << (t + 1 < num_temps ? swap_rate : 0.) << endl;
+  }
+  out.close ();
+  cout << num_temps << " temperatures in " << fixed << setprecision (2)
+       << elapsed << " s on up to " << omp_get_max_threads ()
+       << " threads" << endl;
+  cout << "E, |M|, C and chi per site output to ising_sweep.dat" << endl;
+
+  for (int t = 0; t < num_temps; t++)
+  {
+    delete replica[t];
+  }
+  return (0);
+}
+
+//*********************************************************************//
+// Try to exchange the configurations at kT[t] and kT[t+1] for every
+//  t = parity, parity+2, ...  Returns the number of accepted exchanges;
+//  tried[t] and accepted[t] count the attempts and successes for each t.
+int
+exchange_step (vector<IsingEngine *> &replica, vector<int> &at_temp,
+               const vector<double> &kT, int parity, gsl_rng *rng_ptr,
+               vector<long> &tried, vector<long> &accepted)
+{
+  int num_accepted = 0;
+
+  for (int t = parity; t + 1 < (int) kT.size (); t += 2)
+  {
+    tried[t]++;
+    int r1 = at_temp[t];
+    int r2 = at_temp[t + 1];
+    double delta = (1. / kT[t] - 1. / kT[t + 1])
+      * (replica[r1]->energy () - replica[r2]->energy ());
+    if (delta >= 0. || gsl_rng_uniform (rng_ptr) < exp (delta))
+    {
+      at_temp[t] = r2;		// swap the temperatures
+      at_temp[t + 1] = r1;
+      replica[r2]->set_kT (kT[t]);
+      replica[r1]->set_kT (kT[t + 1]);
+      accepted[t]++;
+      num_accepted++;
+    }
+  }
+  return (num_accepted);
+}
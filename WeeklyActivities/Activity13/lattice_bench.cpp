@@ -0,0 +1,173 @@
+//  file: lattice_bench.cpp
+//
+//  Benchmark for the IsingLattice class: the cost of one Metropolis
+//   spin-flip attempt when the energy change comes from recomputing the
+//   whole energy (as calculate_energy() did in sampling_test.cpp and
+//   ising_model.cpp) and when it comes from the local field,
+//   delta_E = 2 J s h.
+//
+//  Revision history:
+//      26-May-2021  original version
+//      01-Jun-2021  master seed from RngStreams (RNG_SEED repeats a run)
+//
+//  Notes:
+//   * the full recomputation is O(N) per attempt, so O(N^2) per mcs;
+//      the local delta_E is O(1) per attempt, O(N) per mcs.  The table
+//      shows ns per attempt for growing N in 1, 2 and 3 dimensions: the
+//      first column grows like N, the second stays flat.
+//   * both methods see the same random numbers, so they must end with
+//      the same energy; it is also checked against a fresh energy().
+//   * compile with make -f make_lattice_bench
+//
+//*********************************************************************//
+
+// include files
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+using namespace std;
+#include <omp.h>
+#include <gsl/gsl_rng.h>	// GSL random number generators
+#include <gsl/gsl_randist.h>	// GSL random distributions
+
+#include "IsingLattice.h"
+#include "RngStreams.h"		// master seed and streams
+
+// function prototypes
+double metropolis_full (const IsingLattice &lattice, int config[],
+                        int num_attempts, double kT, gsl_rng *rng_ptr,
+                        double &energy);
+double metropolis_local (const IsingLattice &lattice, int config[],
+                         int num_attempts, double kT, gsl_rng *rng_ptr,
+                         double &energy);
+
+const double J_ising = 1.;
+const double kT_bench = 2.5;	// near the 2D critical temperature
+
+//*********************************************************************//
+int
+main (void)
+{
+  unsigned long int seed = RngStreams::master_seed ();
+  gsl_rng *rng_ptr = gsl_rng_alloc (gsl_rng_taus);
+  cout << endl;
+
+  const int sizes[3][5] = { {256, 1024, 4096, 16384, 65536},
+                            {16, 32, 64, 128, 256},
+                            {6, 10, 16, 25, 40} };
+
+  cout << "# dim       N   full ns/attempt  local ns/attempt  energies"
+       << endl;
+  for (int dimension = 1; dimension <= 3; dimension++)
+  {
+    for (int n = 0; n < 5; n++)
+    {
+      IsingLattice lattice (dimension, sizes[dimension - 1][n], true,
+                            J_ising);
+      int N = lattice.get_num_sites ();
+      int *config = new int[N];
+      int *config_full = new int[N];
+
+      // random start, the same for both methods
+      gsl_rng_set (rng_ptr, seed);
+      for (int i = 0; i < N; i++)
+      {
+        config[i] = (gsl_rng_uniform (rng_ptr) < 0.5 ? -1 : +1);
+        config_full[i] = config[i];
+      }
+      double energy_full = lattice.energy (config_full);
+      double energy_local = energy_full;
+
+      // about 10^8 neighbour visits for the full method, at most one mcs
+      int num_attempts = int (1.e8 / (2. * dimension * N));
+      num_attempts = (num_attempts > N ? N : num_attempts);
+      num_attempts = (num_attempts < 1 ? 1 : num_attempts);
+
+      unsigned long int seed_run = gsl_rng_get (rng_ptr);
+      gsl_rng_set (rng_ptr, seed_run);
+      double full_ns = metropolis_full (lattice, config_full, num_attempts,
+                                        kT_bench, rng_ptr, energy_full);
+      gsl_rng_set (rng_ptr, seed_run);
+      metropolis_local (lattice, config, num_attempts, kT_bench, rng_ptr,
+                        energy_local);
+      bool agree = (energy_full == energy_local
+                    && energy_local == lattice.energy (config));
+
+      // the local method is timed over whole sweeps
+      int num_sweeps = 1 + int (2.e7 / N);
+      double local_ns = metropolis_local (lattice, config, num_sweeps * N,
+                                          kT_bench, rng_ptr, energy_local);
+      agree = agree && (energy_local == lattice.energy (config));
+
+      cout << "  " << dimension << "  " << setw (8) << N << "  "
+           << fixed << setprecision (2) << setw (15) << full_ns << "  "
+           << setw (16) << local_ns << "  "
+           << (agree ? "agree" : "DISAGREE") << endl;
+
+      delete[] config;
+      delete[] config_full;
+    }
+  }
+
+  gsl_rng_free (rng_ptr);
+  return (0);
+}
+
+//************************** metropolis_full ******************************
+//
+//  num_attempts single-spin Metropolis attempts (typewriter order) with
+//   delta_E from flipping the spin and recomputing the whole energy.
+//   Returns the time per attempt in ns.
+//
+//*************************************************************************
+double
+metropolis_full (const IsingLattice &lattice, int config[],
+                 int num_attempts, double kT, gsl_rng *rng_ptr,
+                 double &energy)
+{
+  int N = lattice.get_num_sites ();
+  double start = omp_get_wtime ();
+  for (int n = 0; n < num_attempts; n++)
+  {
+    int id = n % N;
+    config[id] = -config[id];
+    double new_energy = lattice.energy (config);
+    double delta_energy = new_energy - energy;
+    double random = gsl_ran_flat (rng_ptr, 0., 1.);
+    if ((delta_energy <= 0.) || (random <= exp (-delta_energy / kT)))
+    {
+      energy = new_energy;
+    }
+    else
+    {
+      config[id] = -config[id];	// rejected, flip back
+    }
+  }
+  return ((omp_get_wtime () - start) / double (num_attempts) * 1.e9);
+}
+
+//************************** metropolis_local *****************************
+//
+//  The same attempts with delta_E = 2 J s h from the neighbour table.
+//
+//*************************************************************************
+double
+metropolis_local (const IsingLattice &lattice, int config[],
+                  int num_attempts, double kT, gsl_rng *rng_ptr,
+                  double &energy)
+{
+  int N = lattice.get_num_sites ();
+  double start = omp_get_wtime ();
+  for (int n = 0; n < num_attempts; n++)
+  {
+    int id = n % N;
+    double delta_energy = lattice.delta_energy (config, id);
+    double random = gsl_ran_flat (rng_ptr, 0., 1.);
+    if ((delta_energy <= 0.) || (random <= exp (-delta_energy / kT)))
+    {
+      config[id] = -config[id];
+      energy += delta_energy;
+    }
+  }
+  return ((omp_get_wtime () - start) / double (num_attempts) * 1.e9);
+}
@@ -14,10 +14,16 @@
 //                    (see random_seed.cpp) and combined into one code
 //      19-Feb-2006  minor upgrades
 //      22-Feb-2009  added energy_i (after various intermediate upgrades)
+//      25-May-2021  exact counts from IsingEnumerator (Gray-code order,
+//                    O(1) energy update) instead of next_configuration
+//      26-May-2021  energies from IsingLattice: O(1) delta_energy per
+//                    Metropolis step instead of calculate_energy
+//      01-Jun-2021  master seed from RngStreams (RNG_SEED repeats a run)
+//      05-Jun-2021  random and Metropolis P(E) in Histograms
 //
 //  Notes:
 //   * the units of energies are such that energies are always integers
-//   * uses the GSL random number functions and random_seed(),
+//   * uses the GSL random number functions and RngStreams,
 //      and both the gsl_rng.h and gsl_randist.h header files are needed.
 //
 //******************************************************************
@@ -31,11 +37,10 @@ using namespace std;
 #include <gsl/gsl_rng.h>	// GSL random number generators
 #include <gsl/gsl_randist.h>	// GSL random distributions
 
-// function prototypes
-extern unsigned long int random_seed ();	// routine to generate a seed
-double calculate_energy (int configuration[]);  // calculate the energy given
-                                                //  a spin configuration
-int next_configuration (int configuration[], int k);  // find next configuration
+#include "IsingEnumerator.h"	// exact energy counts
+#include "IsingLattice.h"	// neighbour table and energies
+#include "RngStreams.h"		// master seed and streams
+#include "Histogram.h"		// sampled energy distributions
 
 // global constants
 const double J_ising = 1.;      // The "J" in the Ising model (+1 or -1 ONLY) 
@@ -51,45 +56,36 @@ inline double energy_i (int i) {return double(i - num_sites);};
 int
 main (void)
 {
-  int energy_count[num_energies];       // exact count of energies at kT   
+  long long energy_count[num_energies]; // exact count of energies at kT   
   double dist_exact[num_energies];      // exact energy distribution at kT 
-  double dist_random[num_energies];     // energy distribution from random     
-                                        //  sampling of configurations         
-  double dist_metropolis[num_energies]; // energy distribution at kT from 
+  // bin i of the histograms is centered on the energy energy_i(i)
+  Histogram dist_random (num_energies, -num_sites - 0.5, num_sites + 0.5);
+                                        // energy distribution from random
+                                        //  sampling of configurations
+  Histogram dist_metropolis (num_energies, -num_sites - 0.5, num_sites + 0.5);
+                                        // energy distribution at kT from 
                                         //  importance sampling (Metropolis)
 
-  // initialize all energy distribution histograms to zero
+  // initialize the exact energy distribution to zero
   for (int i = 0; i < num_energies; i++)
   {
     energy_count[i] = 0;
     dist_exact[i] = 0.;
-    dist_random[i] = 0.;
-    dist_metropolis[i] = 0.;
   }
 
   //******************************************************************
   // Find the exact canonical ensemble energy probability distribution at kT
   
-  // initialize the current configuration as all spin down
-  int config_exact[num_sites];
-  for (int i = 0; i < num_sites; i++)
+  // count the configurations at each energy: energy_count[i] is the
+  //  number with energy energy_i(i) (the ring has num_sites bonds)
+  IsingEnumerator ring (num_sites, 1, J_ising);
+  ring.count_energies (energy_count);
+  long long num_configs = 0;   // keep track of how many configurations are found
+  for (int i = 0; i < num_energies; i++)
   {
-    config_exact[i] = -1;
+    num_configs += energy_count[i];
+    // Note that energy_count[i] is non-zero only for some i's
   }
-    
-  // generate each successive configuration and find its energy
-  int num_configs = 0;   // keep track of how many configurations are found
-  int end = 0;
-  do   // Note the "while" statement below --> check "end" 
-  {
-     int k = 0;
-     end = next_configuration (config_exact, k); // generate the next config.
-     num_configs++;
-     double energy = calculate_energy (config_exact);  
-     energy_count[num_sites + int(energy)]++;  // histogram the energies
-     // Note that energy_count[i] is non-zero only for some i's      
-  } 
-  while (end != 1);  // end when all configs. are considered (so end=1)
   cout << num_configs << " total configurations" << endl << endl;
    
   // find the partition function at temperature kT
@@ -108,9 +104,11 @@ main (void)
   //*******************************************************************
   // Find the energy distribution from randomly selected configurations
   
+  // the ring of spins (periodic boundary conditions)
+  IsingLattice lattice (1, num_sites, true, J_ising);
+
   //  Use the GSL random number generators (rng's)
-  gsl_rng *rng_ptr = gsl_rng_alloc (gsl_rng_taus);   // allocate an rng 
-  gsl_rng_set (rng_ptr, random_seed());	             // seed the rng 
+  gsl_rng *rng_ptr = RngStreams::thread_rng ();	// seeded from the master seed
   
   int config_random[num_sites];   // current configuration  
   for (int config = 0; config < num_samples; config++)
@@ -128,18 +126,13 @@ main (void)
         config_random[i] = +1;  // spin up
       }
     }          
-    double energy = calculate_energy( config_random );
-    dist_random[num_sites + int(energy)]++;
+    double energy = lattice.energy( config_random );
+    dist_random.add (energy);
   }    
-  // normalize the energy distribution
-  for (int i = 0; i < num_energies; i++)
-  {
-    dist_random[i] /= double(num_samples);
-  }
   
   //*******************************************************************
   // Find the energy distribution from a Markov chain of configurations
-  double energy, energy0;
+  double energy0;
   int config_metropolis[num_sites];
 
   // generate a random configuration to start and find its energy
@@ -155,7 +148,7 @@ main (void)
       config_metropolis[i] = +1;  // spin up
     }
   } 
-  energy0 = calculate_energy ( config_metropolis );
+  energy0 = lattice.energy ( config_metropolis );
   
   // Take num_samples Monte Carlo steps (mcs)  
   for (int config = 0; config < num_samples; config++)
@@ -166,31 +159,20 @@ main (void)
       double random = gsl_ran_flat (rng_ptr, 0., 1.);
       int id = int(random * num_sites);   // compute the site number
 
-      // flip that spin (if +/- 1, change to -/+ 1)
-      config_metropolis[id] *= -1;  
-
-      energy = calculate_energy( config_metropolis );  // new energy
-      double delta_energy = energy - energy0;
+      // energy change if that spin is flipped: O(1) from its neighbours
+      double delta_energy = lattice.delta_energy (config_metropolis, id);
 
       // decide whether to accept or reject the new configuration
       random = gsl_ran_flat (rng_ptr, 0., 1.);
-      if ( (delta_energy > 0.) && (random > exp(-delta_energy/kT)) )
-      {
-        // reject the new configuration: flip the spin back
-        config_metropolis[id] *= -1; 
-      }
-      else
+      if ( (delta_energy <= 0.) || (random <= exp(-delta_energy/kT)) )
       {
-        energy0 = energy;  // accept the new configuration
+        // accept the new configuration: flip the spin (if +/- 1,
+        //  change to -/+ 1)
+        config_metropolis[id] *= -1;
+        energy0 += delta_energy;
       }
     }
-    dist_metropolis[num_sites + int(energy0)] += 1.;  // add to distribution
-  }
-    
-  // normalize the distribution
-  for (int i = 0; i < num_energies; i++)
-  {
-    dist_metropolis[i] /= double(num_samples);
+    dist_metropolis.add (energy0);  // add to distribution
   }
 
   //*******************************************************************
@@ -201,75 +183,11 @@ main (void)
     cout << fixed << "  " << setw(5) << i - num_sites << "  "
          << fixed << setprecision(8)
          << setw(11) << dist_exact[i] << "  "
-         << setw(11) << dist_random[i] << "  "
-         << setw(11) << dist_metropolis[i] << " "
+         << setw(11) << dist_random.probability (i) << "  "
+         << setw(11) << dist_metropolis.probability (i) << " "
          << endl;
   }
   cout << endl;
 
   return (0);
 }
-
-//************************* calculate_energy ******************************
-//
-//  Given the array of integers configuration[0...num_sites-1], which 
-//   specifies the spin at each lattice point, find the energy of that 
-//   configuration [eq.(13.6) in Session 13 notes].
-//  Note that a boundary condition for the endpoints is specified here.
-//
-//*************************************************************************
-double 
-calculate_energy (int configuration[])
-{
-  int nearest = 0;
-  double energy = 0.;
-  
-  for (int i=0; i < num_sites - 1; i++)  // step through all but one site
-  {
-    nearest = i + 1;   // nearest neighbor on a line
-    energy += - J_ising * double(configuration[i] * configuration[nearest]);
-  }
-    
-  // now for the last site using the boundary condition
-  nearest = num_sites - 1;
-  energy += - J_ising * double(configuration[nearest] * configuration[0]);
-
-  return (energy);
-} 
-
-//************************* next_configuration ******************************
-//
-//  Given an input array of integers configuration[], which specifies the 
-//   spin at each lattice point and the current site, find the next 
-//   configuration.  The ordering corresponds to counting up in base 2, 
-//   with a down spin (-1) being 0 and an up spin (+1) being 1.
-//  Calling next_configuration repeatedly steps through all of the possible
-//   spin configurations.  This may be too clever to be reliable! 
-//
-//*************************************************************************
-int 
-next_configuration (int configuration[], int k)
-{
-  int end = 0;   // flag for when to quit
-  
-  if (configuration[k] == -1)
-  {
-    configuration[k] = +1;  // if the current spin is down, flip it
-  }
-  else
-  {
-    configuration[k] = -1;  // flip the current spin from up to down
-    k++;
-    if (k < num_sites)
-    {
-      end = next_configuration (configuration, k);  // recursion!!
-    }
-    else
-    {
-      end = 1;   // quit at this point
-    }
-  }
-    
-  return (end);
-}
-
@@ -0,0 +1,234 @@
+//  file: wang_landau.cpp
+//
+//  Program to estimate the density of states g(E) of the two-dimensional
+//   Ising model on an L x L periodic lattice by Wang-Landau sampling,
+//   and from it the free energy, energy and specific heat per site over
+//   a range of temperatures, all from one run.
+//
+//  Revision history:
+//      28-May-2021  original version
+//      01-Jun-2021  master seed from RngStreams (RNG_SEED repeats a run)
+//      07-Jun-2021  accuracy measured with three seeds
+//
+//  Notes:
+//   * for L <= 6 the estimate is compared with the exact counts from
+//      IsingEnumerator (the largest error in ln g is printed).  For any
+//      L, <E>/N and C/N are compared with the exact results from
+//      Kaufman's partition function of the finite periodic lattice.
+//   * the error shrinks as final ln f gets smaller, and the time grows
+//      like 1/(final ln f).  With 16 windows of one walker each
+//      (RNG_SEED = 7, 11 and 13, one core):
+//        16 x 16 to 1.e-6, about 7 s: peak of C/N within 0.5%, C/N
+//          everywhere within 0.025 of the exact (peak 1.552)
+//        64 x 64 to 1.e-5, about 25 s: peak of C/N off by up to 18%,
+//          C/N within 0.6 (peak 2.251); ln g(E_min) off by up to 1.7
+//        64 x 64 to 1.e-6, about 4 min: peak of C/N within 9%, C/N
+//          within 0.25, ln g(E_min) within 0.2 of ln 2
+//      The error comes from the walks inside the windows, not from
+//      joining them: neighbouring windows differ by about 0.1 in ln g
+//      across an overlap, and joining at a single energy instead gives
+//      errors of the same size.  For 64 x 64 use 1.e-6 or smaller, or
+//      more walkers per window.
+//   * the specific heat of the infinite lattice diverges at
+//      kT_c = 2/ln(1+sqrt(2)) = 2.269; for finite L the peak is a bit
+//      above that, and gets higher and narrower as L grows.
+//   * ln g(E) goes to wang_landau.dat, and F/N, <E>/N and C/N to
+//      wang_landau_thermo.dat
+//   * compile with make -f make_wang_landau (needs -fopenmp)
+//
+//*********************************************************************//
+
+// include files
+#include <iostream>		// cout and cin
+#include <iomanip>		// manipulators like setprecision
+#include <fstream>		// file input and output
+#include <cmath>
+using namespace std;
+#include <omp.h>
+
+#include "WangLandau.h"
+#include "IsingEnumerator.h"	// exact counts for small lattices
+#include "RngStreams.h"		// master seed and streams
+
+// function prototypes
+double kaufman_ln_Z (int L, double kT);
+void kaufman_thermodynamics (int L, double kT, double &energy,
+                             double &specific_heat);
+
+//*********************************************************************//
+int
+main (void)
+{
+  int L, num_windows, walkers_per_window, num_threads;
+  double final_ln_f;
+  unsigned long int seed = RngStreams::master_seed ();
+
+  cout << "Linear size L (even, e.g. 64): ";
+  cin >> L;
+  cout << "Number of energy windows and walkers per window (e.g. 16 1): ";
+  cin >> num_windows >> walkers_per_window;
+  cout << "Final ln f (e.g. 1.e-6): ";
+  cin >> final_ln_f;
+  cout << "Number of threads (0 = all): ";
+  cin >> num_threads;
+
+  WangLandau wang_landau (2, L, num_windows, walkers_per_window, seed);
+  wang_landau.set_final_ln_f (final_ln_f);
+  wang_landau.set_threads (num_threads);
+
+  double start = omp_get_wtime ();
+  wang_landau.run ();
+  double elapsed = omp_get_wtime () - start;
+  cout << wang_landau.get_num_flips () << " spin-flip attempts in "
+       << fixed << setprecision (2) << elapsed << " s" << endl;
+
+  int N = wang_landau.get_num_sites ();
+  int num_energies = wang_landau.get_num_energies ();
+  cout << "ln g(E_min) = " << setprecision (4) << wang_landau.ln_g (0)
+       << " (exact: ln 2 = " << log (2.) << ")" << endl;
+
+  // exact counts if the lattice is small enough to enumerate
+  long long *energy_count = 0;
+  if (L <= 6)
+  {
+    IsingEnumerator exact (L, L);
+    energy_count = new long long[num_energies];
+    exact.count_energies (energy_count, num_threads);
+    double max_error = 0.;
+    for (int i = 0; i < num_energies; i++)
+    {
+      if (energy_count[i] > 0)
+      {
+        double error = fabs (wang_landau.ln_g (i)
+                             - log (double (energy_count[i])));
+        max_error = (error > max_error ? error : max_error);
+      }
+    }
+    cout << "largest error in ln g(E) vs. exact: " << scientific
+         << setprecision (2) << max_error << endl;
+  }
+
+  // output ln g(E)
+  ofstream out;
+  out.open ("wang_landau.dat");
+  out << "# Wang-Landau density of states, L = " << L << ", final ln f = "
+      << final_ln_f << endl;
+  out << "#  energy       ln g(E)" << (energy_count ? "     exact" : "")
+      << endl;
+  for (int i = 0; i < num_energies; i++)
+  {
+    if (wang_landau.reached (i))
+    {
+      out << "  " << setw (7) << int (wang_landau.energy_i (i)) << "  "
+          << fixed << setprecision (6) << setw (12) << wang_landau.ln_g (i);
+      if (energy_count)
+      {
+        out << "  " << setw (12) << log (double (energy_count[i]));
+      }
+      out << endl;
+    }
+  }
+  out.close ();
+
+  // thermodynamics at every temperature from the same ln g(E)
+  out.open ("wang_landau_thermo.dat");
+  out << "# Ising model from Wang-Landau g(E), L = " << L << endl;
+  out << "#   kT        F/N          <E>/N        C/N      exact <E>/N"
+      << "  exact C/N" << endl;
+  double kT_peak = 0., C_peak = 0., C_peak_exact = 0., max_dC = 0.;
+  for (double kT = 0.5; kT < 5.001; kT += 0.01)
+  {
+    double ln_Z, energy, specific_heat;
+    wang_landau.thermodynamics (kT, ln_Z, energy, specific_heat);
+    double energy_exact, specific_heat_exact;
+    kaufman_thermodynamics (L, kT, energy_exact, specific_heat_exact);
+    out << fixed << setprecision (4) << setw (8) << kT << "  "
+        << setprecision (6) << setw (11) << -kT * ln_Z / N << "  "
+        << setw (11) << energy / N << "  " << setw (11)
+        << specific_heat / N << "  " << setw (11) << energy_exact / N
+        << "  " << setw (11) << specific_heat_exact / N << endl;
+    if (specific_heat / N > C_peak)
+    {
+      C_peak = specific_heat / N;
+      kT_peak = kT;
+    }
+    if (specific_heat_exact / N > C_peak_exact)
+    {
+      C_peak_exact = specific_heat_exact / N;
+    }
+    double dC = fabs (specific_heat - specific_heat_exact) / N;
+    max_dC = (dC > max_dC ? dC : max_dC);
+  }
+  out.close ();
+  cout << "peak of C/N = " << fixed << setprecision (4) << C_peak
+       << " at kT = " << setprecision (2) << kT_peak << " (exact peak "
+       << setprecision (4) << C_peak_exact << ", largest error in C/N "
+       << max_dC << ")" << endl;
+  cout << "ln g(E) output to wang_landau.dat, F/N, <E>/N and C/N to "
+       << "wang_landau_thermo.dat" << endl;
+
+  delete[] energy_count;
+  return (0);
+}
+
+//*********************************************************************//
+// ln Z of the L x L periodic lattice (J = 1) from Kaufman's formula,
+//  Z = (1/2) (2 sinh 2K)^(N/2) (Z_1 + Z_2 + Z_3 + Z_4) with K = 1/kT,
+//  each Z_i a product over L values of gamma_k; the products are summed
+//  as logarithms (with their signs) so nothing overflows.
+double
+kaufman_ln_Z (int L, double kT)
+{
+  double K = 1. / kT;
+  double sign[4], ln_term[4];
+  for (int n = 0; n < 4; n++)
+  {
+    sign[n] = 1.;
+    ln_term[n] = 0.;
+    for (int r = 0; r < L; r++)
+    {
+      int k = (n < 2 ? 2 * r + 1 : 2 * r);	// odd k for Z_1, Z_2
+      double gamma;
+      if (k == 0)
+      {
+        gamma = 2. * K + log (tanh (K));
+      }
+      else
+      {
+        gamma = acosh (cosh (2. * K) / tanh (2. * K) - cos (M_PI * k / L));
+      }
+      // ln(2 cosh x) or ln|2 sinh x|, without overflow for large x
+      double x = 0.5 * L * gamma;
+      double damp = exp (-2. * fabs (x));
+      ln_term[n] += fabs (x) + (n % 2 == 0 ? log1p (damp) : log1p (-damp));
+      sign[n] *= (n % 2 == 1 && x < 0. ? -1. : 1.);
+    }
+  }
+  double ln_max = ln_term[0];
+  for (int n = 1; n < 4; n++)
+  {
+    ln_max = (ln_term[n] > ln_max ? ln_term[n] : ln_max);
+  }
+  double sum = 0.;
+  for (int n = 0; n < 4; n++)
+  {
+    sum += sign[n] * exp (ln_term[n] - ln_max);
+  }
+  return (log (0.5) + 0.5 * L * L * log (2. * sinh (2. * K)) + ln_max
+          + log (sum));
+}
+
+// <E> = kT^2 d(ln Z)/dkT and C = d<E>/dkT, by central differences
+void
+kaufman_thermodynamics (int L, double kT, double &energy,
+                        double &specific_heat)
+{
+  const double h = 1.e-3;
+  double ln_Z_minus = kaufman_ln_Z (L, kT - h);
+  double ln_Z_0 = kaufman_ln_Z (L, kT);
+  double ln_Z_plus = kaufman_ln_Z (L, kT + h);
+  energy = kT * kT * (ln_Z_plus - ln_Z_minus) / (2. * h);
+  double d2 = (ln_Z_plus - 2. * ln_Z_0 + ln_Z_minus) / (h * h);
+  double d1 = (ln_Z_plus - ln_Z_minus) / (2. * h);
+  specific_heat = 2. * kT * d1 + kT * kT * d2;
+}